@@ -11,63 +11,20 @@
 #include <iostream>
 #include <vector>
 #include <algorithm> // std::sort, std::inplace_merge, std::is_sorted
-#include <future>    // std::async, std::future
-#include <random>    // 生成随机数
 #include <chrono>    // 计时器
 #include <thread>    // 获取硬件并发数
 
+#include "../week_3/ParallelSort.h"
+#include "../week_3/DataGen.h"
+
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
-// NOLINTNEXTLINE(misc-no-recursion)
-template <typename RandomIt>
-void parallel_merge_sort(RandomIt begin, RandomIt end)
-{
-    //1. 获取数据长度
-    auto len = std::distance(begin,end);
-
-    // 2. 【递归终止条件】
-    // 如果数据太少（比如少于 1000 个），开启线程的开销反而比排序本身大。
-    // 这时候直接用普通的 std::sort 就行
-    if (len < 1000)
-    {
-        std::sort(begin,end);
-        return;
-    }
-
-    // 3. 【任务分割】
-    // 找到中间位置
-    RandomIt mid = begin + len / 2;
-
-    // 4. 【异步启动左半边】
-    // 关键点：
-    // - 使用 std::async
-    // - 策略选 std::launch::async (强制新线程)
-    // - 递归调用 parallel_merge_sort
-    // - 参数是 begin 和 mid
-    // - 这里的返回值类型是 std::future<void>，因为函数返回 void
-    if (len > 100000)
-    {
-        //只有数据量足够大才开线程
-        auto left_future = std::async(std::launch::async | std::launch::deferred, [begin, mid]() {
-            parallel_merge_sort<RandomIt>(begin, mid);
-        });
-        parallel_merge_sort(mid,end);
-        // - 左半边：正在后台线程排序...
-        // - 右半边：已经在当前线程排好了。
-        // 必须等待左半边也排好，才能合并。
-        left_future.get();
-    } else
-    {
-        parallel_merge_sort(begin, mid);
-        parallel_merge_sort(mid,end);
-    }
-
-    // 7. 【合并有序序列】
-    std::inplace_merge(begin,mid,end);
-
-}
+// parallel_merge_sort 已经搬到 week_3/ParallelSort.h：
+// 原来每次切分都 std::async(std::launch::async | std::launch::deferred, ...) 一次，
+// 要么真的开一个系统线程，要么被实现悄悄变成 deferred 串行；1000 / 100000 两个阈值也是写死的。
+// 现在是常驻工作窃取池上的 fork-join：等子任务的线程会去偷别的活干，叶子大小按数据量和核心数自动定
 
 int main()
 {
@@ -80,20 +37,21 @@ int main()
     const size_t DATA_SIZE = 50000000;
     std::cout << "========================================" << std::endl;
     std::cout << "CPU 核心数: " << std::thread::hardware_concurrency() << std::endl;
+    std::cout << "工作窃取池工人数: " << default_work_stealing_pool().thread_count() << std::endl;
     std::cout << "测试数据量: " << DATA_SIZE << " 个整数" << std::endl;
     std::cout << "正在生成随机数据..." << std::endl;
 
-    // 生成随机数据
-    std::vector<int> data_source(DATA_SIZE);
-    std::mt19937 gen(std::random_device{}());
-    std::uniform_int_distribution<> dis(1, 1000000000);
-    for (auto& num : data_source) {
-        num = dis(gen);
-    }
+    // 生成随机数据：固定种子、多线程并行生成（见 week_3/DataGen.h），每次运行、不管几个核都是同一份输入
+    // RandomVector 不清零，5000 万个元素只被并行生成写一遍
+    auto start_gen = std::chrono::high_resolution_clock::now();
+    RandomVector<int> data_source = make_random_vector<int>(DATA_SIZE, 42, UniformInt<int>(1, 1000000000));
+    auto end_gen = std::chrono::high_resolution_clock::now();
+    std::cout << "生成耗时: " << std::chrono::duration_cast<std::chrono::milliseconds>(end_gen - start_gen).count() << " ms"
+              << std::endl;
 
     // 复制两份一样的数据，公平竞争
 //    std::vector<int> data_seq = data_source;
-    std::vector<int> data_par = data_source;
+    RandomVector<int> data_par = data_source;
 
     std::cout << "数据生成完毕，开始测试！" << std::endl;
     std::cout << "========================================" << std::endl;
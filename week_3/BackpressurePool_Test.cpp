@@ -0,0 +1,124 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <mutex>
+#include "ThreadPool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+const char* policy_name(OverflowPolicy p) {
+    switch (p) {
+        case OverflowPolicy::Block:      return "Block";
+        case OverflowPolicy::Reject:     return "Reject";
+        case OverflowPolicy::CallerRuns: return "CallerRuns";
+        case OverflowPolicy::DropOldest: return "DropOldest";
+        case OverflowPolicy::Spill:      return "Spill";
+    }
+    return "?";
+}
+
+// 1 个工人 + 容量 4 的队列，瞬间塞 20 个 20ms 的任务，看各策略怎么“降级”
+void run_policy(OverflowPolicy policy) {
+    std::atomic<int> executed{0};
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::milliseconds submit_cost{0};
+    OverflowStats stats;
+    {
+        ThreadPoolOptions opt = ThreadPoolOptions::fixed(1);
+        opt.queue_capacity = 4;
+        opt.overflow_policy = policy;
+        ThreadPool pool(opt);
+
+        for (int i = 0; i < 20; ++i) {
+            pool.enqueue([&executed] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                ++executed;
+            });
+        }
+        submit_cost = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+        stats = pool.overflow_stats();
+    } // 析构时 join，等剩下的任务跑完
+
+    std::cout << policy_name(policy)
+              << "\t提交耗时: " << submit_cost.count() << " ms"
+              << "\t执行: " << executed.load()
+              << "\trejected=" << stats.rejected
+              << " caller_runs=" << stats.caller_runs
+              << " dropped=" << stats.dropped
+              << " spilled=" << stats.spilled << std::endl;
+}
+
+// Spill 不丢任务，也不打乱顺序：溢出队列非空时新任务排到它后面，而不是抢进主队列刚空出的位置
+// 任务很短，工人取走一个、回填之前的那一下空档会被提交线程频繁撞上
+void spill_order() {
+    const int kTasks = 200000;
+    std::vector<int> order;
+    std::mutex mtx;
+    {
+        ThreadPoolOptions opt = ThreadPoolOptions::fixed(1);
+        opt.queue_capacity = 4;
+        opt.overflow_policy = OverflowPolicy::Spill;
+        ThreadPool pool(opt);
+        for (int i = 0; i < kTasks; ++i) {
+            pool.enqueue([i, &order, &mtx] {
+                std::lock_guard<std::mutex> lock(mtx);
+                order.push_back(i);
+            });
+        }
+    }
+    bool in_order = order.size() == static_cast<size_t>(kTasks);
+    for (size_t i = 0; in_order && i < order.size(); ++i) in_order = order[i] == static_cast<int>(i);
+    std::cout << "Spill 执行顺序: " << (in_order ? "和提交顺序一致" : "被打乱了!") << std::endl;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    std::cout << "=== 队列满时的各种策略 ===" << std::endl;
+    run_policy(OverflowPolicy::Block);
+    run_policy(OverflowPolicy::Reject);
+    run_policy(OverflowPolicy::CallerRuns);
+    run_policy(OverflowPolicy::DropOldest);
+    run_policy(OverflowPolicy::Spill);
+    spill_order();
+
+    std::cout << "\n=== try_enqueue / enqueue_for ===" << std::endl;
+    ThreadPoolOptions opt = ThreadPoolOptions::fixed(1);
+    opt.queue_capacity = 2;
+    ThreadPool pool(opt);
+
+    int accepted = 0;
+    for (int i = 0; i < 10; ++i) {
+        if (pool.try_enqueue([] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); })) {
+            ++accepted;
+        }
+    }
+    std::cout << "try_enqueue 接受: " << accepted << " / 10" << std::endl;
+
+    // 工人可能已经取走了一个，先把队列重新塞满
+    while (pool.try_enqueue([] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); })) {}
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = pool.enqueue_for([] {}, std::chrono::milliseconds(10));
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+    std::cout << "enqueue_for(10ms): " << (ok ? "成功" : "超时")
+              << "，等了 " << waited.count() << " ms" << std::endl;
+
+    OverflowStats stats = pool.overflow_stats();
+    std::cout << "rejected=" << stats.rejected << " timed_out=" << stats.timed_out << std::endl;
+    return 0;
+}
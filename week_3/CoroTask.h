@@ -0,0 +1,325 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_COROTASK_H
+#define CONCURRENCY_STUDY_COROTASK_H
+
+// 需要 C++20：只在单独的 Coroutine_Study 目标里使用（见 CMakeLists.txt）
+#if __cplusplus < 202002L && !(defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#error "CoroTask.h requires C++20 coroutines"
+#endif
+
+#include <coroutine>
+#include <optional>
+#include <exception>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <type_traits>
+#include <utility>
+
+#include "ThreadPool.h"
+
+// =========================
+// 协程层：task<T> + schedule_on(pool) + submit + when_all + sync_wait
+// 协程挂起时只是一块堆上的帧，不占任何线程；
+// 被唤醒时由线程池的某个工人接着往下跑，所以几个工人就能撑住上万个在途请求
+// =========================
+namespace coro {
+
+template<typename T = void>
+class task;
+
+namespace detail {
+
+// 协程结束时直接“跳”回等待它的那个协程（对称转移，不会越递归越深）
+struct final_awaiter {
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) const noexcept {
+        auto cont = h.promise().continuation_;
+        return cont ? cont : std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+struct promise_base {
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr error_;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; } // 惰性启动：被 co_await 才开始跑
+    final_awaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { error_ = std::current_exception(); }
+};
+
+template<typename T>
+struct task_promise : promise_base {
+    std::optional<T> value_;
+
+    task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U&& v) { value_.emplace(std::forward<U>(v)); }
+
+    T result() {
+        if (error_) std::rethrow_exception(error_);
+        return std::move(*value_);
+    }
+};
+
+template<>
+struct task_promise<void> : promise_base {
+    task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    void result() const {
+        if (error_) std::rethrow_exception(error_);
+    }
+};
+
+// 启动即运行、结束即销毁的协程：when_all / sync_wait 内部用来“挂”在子任务后面
+struct detached {
+    struct promise_type {
+        detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+template<typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = detail::task_promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    explicit task(handle_type h) noexcept : h_(h) {}
+    task(task&& other) noexcept : h_(std::exchange(other.h_, {})) {}
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (h_) h_.destroy();
+            h_ = std::exchange(other.h_, {});
+        }
+        return *this;
+    }
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    ~task() {
+        if (h_) h_.destroy();
+    }
+
+    // co_await task：启动它，等它结束后取结果（或重新抛出它的异常）
+    bool await_ready() const noexcept { return !h_ || h_.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        h_.promise().continuation_ = awaiting;
+        return h_;
+    }
+
+    T await_resume() { return h_.promise().result(); }
+
+    // 只等结束、不取结果：结果留在 promise 里，之后用 result() 拿
+    auto when_ready() noexcept {
+        struct awaiter {
+            handle_type h;
+            bool await_ready() const noexcept { return !h || h.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                h.promise().continuation_ = awaiting;
+                return h;
+            }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{h_};
+    }
+
+    T result() { return h_.promise().result(); }
+
+private:
+    handle_type h_;
+};
+
+namespace detail {
+
+template<typename T>
+task<T> task_promise<T>::get_return_object() noexcept {
+    return task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+}
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+}
+
+// 把 h 交给线程池恢复；返回 false 表示没交出去（池子已经停了），调用者应当在当前线程直接继续
+// 走 enqueue_must_run：不阻塞、不受溢出策略影响，DropOldest 也不会把它挤掉——丢了协程就永远挂着
+inline bool resume_on(ThreadPool& pool, std::coroutine_handle<> h) {
+    return pool.enqueue_must_run([h]() { h.resume(); });
+}
+
+} // namespace detail
+
+// co_await schedule_on(pool)：把当前协程剩下的部分挪到线程池的工人上执行
+inline auto schedule_on(ThreadPool& pool) noexcept {
+    struct awaiter {
+        ThreadPool& pool;
+        bool await_ready() const noexcept { return false; }
+        // 返回 false 表示没挂起，就在当前线程继续跑
+        bool await_suspend(std::coroutine_handle<> h) const {
+            return detail::resume_on(pool, h);
+        }
+        void await_resume() const noexcept {}
+    };
+    return awaiter{pool};
+}
+
+// co_await submit(pool, fn)：fn 在线程池里执行，协程拿到返回值后在那个工人上继续
+template<typename F>
+task<std::invoke_result_t<F>> submit(ThreadPool& pool, F fn) {
+    co_await schedule_on(pool);
+    co_return fn();
+}
+
+// =========================
+// when_all：同时启动一组 task，全部结束后恢复等待者；等待期间不占线程
+// =========================
+namespace detail {
+
+struct when_all_state {
+    std::atomic<size_t> remaining;
+    std::coroutine_handle<> waiter;
+};
+
+template<typename T>
+detached when_all_child(task<T>& t, when_all_state& state) {
+    co_await t.when_ready();
+    if (state.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        state.waiter.resume();
+    }
+}
+
+template<typename T>
+struct when_all_awaiter {
+    std::vector<task<T>>& tasks;
+    when_all_state state{};
+
+    bool await_ready() const noexcept { return tasks.empty(); }
+
+    bool await_suspend(std::coroutine_handle<> h) {
+        state.waiter = h;
+        // 多算一个 1：防止子任务在我们还没启动完时就把计数减到 0
+        state.remaining.store(tasks.size() + 1, std::memory_order_relaxed);
+        for (auto& t : tasks) when_all_child(t, state);
+        // 如果子任务都已经同步完成，就不挂起了
+        return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+} // namespace detail
+
+template<typename T>
+task<std::vector<T>> when_all(std::vector<task<T>> tasks) {
+    co_await detail::when_all_awaiter<T>{tasks};
+    std::vector<T> results;
+    results.reserve(tasks.size());
+    for (auto& t : tasks) results.push_back(t.result());
+    co_return results;
+}
+
+inline task<void> when_all(std::vector<task<void>> tasks) {
+    co_await detail::when_all_awaiter<void>{tasks};
+    for (auto& t : tasks) t.result(); // 有异常就抛出第一个
+}
+
+// =========================
+// async_event：一次性事件，set() 之前 co_await 它的协程都挂起（不占线程），
+// set() 之后全部交给线程池恢复。用来模拟“等 IO 完成”
+// =========================
+class async_event {
+public:
+    explicit async_event(ThreadPool& pool) : pool_(pool) {}
+
+    auto operator co_await() noexcept {
+        struct awaiter {
+            async_event& ev;
+            bool await_ready() const noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<> h) {
+                std::lock_guard<std::mutex> lock(ev.mtx_);
+                if (ev.set_) return false;
+                ev.waiters_.push_back(h);
+                return true;
+            }
+            void await_resume() const noexcept {}
+        };
+        return awaiter{*this};
+    }
+
+    void set() {
+        std::vector<std::coroutine_handle<>> waiters;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            set_ = true;
+            waiters.swap(waiters_);
+        }
+        for (auto h : waiters) {
+            if (!detail::resume_on(pool_, h)) h.resume();
+        }
+    }
+
+    size_t waiting() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return waiters_.size();
+    }
+
+private:
+    ThreadPool& pool_;
+    mutable std::mutex mtx_;
+    bool set_ = false;
+    std::vector<std::coroutine_handle<>> waiters_;
+};
+
+// =========================
+// sync_wait：在普通线程（比如 main）里阻塞等一个 task 跑完；不要在线程池工人里用
+// =========================
+namespace detail {
+
+struct sync_wait_state {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done = false;
+};
+
+template<typename T>
+detached sync_wait_child(task<T>& t, sync_wait_state& state) {
+    co_await t.when_ready();
+    // 持锁通知：sync_wait 一返回 state 就没了
+    std::lock_guard<std::mutex> lock(state.mtx);
+    state.done = true;
+    state.cv.notify_one();
+}
+
+} // namespace detail
+
+template<typename T>
+T sync_wait(task<T> t) {
+    detail::sync_wait_state state;
+    detail::sync_wait_child(t, state);
+    {
+        std::unique_lock<std::mutex> lock(state.mtx);
+        state.cv.wait(lock, [&state]() { return state.done; });
+    }
+    return t.result();
+}
+
+} // namespace coro
+
+#endif //CONCURRENCY_STUDY_COROTASK_H
@@ -0,0 +1,111 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <atomic>
+#include "CoroTask.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 对比 day_4_async_future_demo：那边每个 future.get() 都要占着一个线程干等，
+// 这里的请求处理函数写成直线代码，等待期间协程挂起，不占线程
+
+// CPU 活：丢给线程池算
+int calculate_sqrt(int x) {
+    return static_cast<int>(std::sqrt(x));
+}
+
+// 一个“请求处理函数”：切到线程池 -> 算一点东西 -> 等 IO -> 返回
+coro::task<int> handle_request(ThreadPool& pool, coro::async_event& io_ready, int id) {
+    co_await coro::schedule_on(pool);
+
+    int parsed = co_await coro::submit(pool, [id] { return calculate_sqrt(id); });
+
+    co_await io_ready; // 模拟等数据库/网络：挂起期间不占用任何工人
+
+    co_return parsed;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    ThreadPoolOptions opt = ThreadPoolOptions::fixed(4);
+    opt.queue_capacity = 1024;
+    ThreadPool pool(opt);
+    coro::async_event io_ready(pool);
+
+    const int N = 20000;
+    std::vector<coro::task<int>> requests;
+    requests.reserve(N);
+    for (int i = 0; i < N; ++i) {
+        requests.push_back(handle_request(pool, io_ready, i));
+    }
+
+    // 另一个线程模拟“IO 完成”：等所有请求都挂在事件上以后再放行
+    std::thread io_thread([&io_ready, &pool, N]() {
+        while (io_ready.waiting() < static_cast<size_t>(N)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::cout << "在途请求: " << io_ready.waiting()
+                  << "，线程池工人数: " << pool.thread_count() << std::endl;
+        io_ready.set();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> results = coro::sync_wait(coro::when_all(std::move(requests)));
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    io_thread.join();
+
+    long long sum = 0;
+    for (int r : results) sum += r;
+    std::cout << "完成 " << results.size() << " 个请求，结果和 = " << sum
+              << "，耗时 " << ms << " ms" << std::endl;
+
+    // 异常也能跨 co_await 传回来
+    auto failing = [](ThreadPool& p) -> coro::task<void> {
+        co_await coro::schedule_on(p);
+        throw std::runtime_error("handler failed");
+    };
+    try {
+        coro::sync_wait(failing(pool));
+    } catch (const std::exception& e) {
+        std::cout << "捕获异常: " << e.what() << std::endl;
+    }
+
+    // DropOldest 池子：队列一直被普通任务塞满，协程的恢复不会被挤掉（否则 sync_wait 永远等不到）
+    {
+        ThreadPoolOptions drop = ThreadPoolOptions::fixed(2);
+        drop.queue_capacity = 8;
+        drop.overflow_policy = OverflowPolicy::DropOldest;
+        ThreadPool lossy(drop);
+
+        std::atomic<bool> flooding{true};
+        std::thread flooder([&lossy, &flooding]() {
+            while (flooding.load()) lossy.enqueue([] { std::this_thread::sleep_for(std::chrono::microseconds(50)); });
+        });
+
+        std::vector<coro::task<int>> hops;
+        for (int i = 0; i < 2000; ++i) {
+            hops.push_back(coro::submit(lossy, [i] { return i % 7; }));
+        }
+        std::vector<int> got = coro::sync_wait(coro::when_all(std::move(hops)));
+        flooding.store(false);
+        flooder.join();
+        std::cout << "DropOldest 池上 " << got.size() << " 个协程全部完成，期间挤掉普通任务 "
+                  << lossy.overflow_stats().dropped << " 个" << std::endl;
+    }
+
+    return 0;
+}
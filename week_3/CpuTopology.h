@@ -0,0 +1,116 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_CPUTOPOLOGY_H
+#define CONCURRENCY_STUDY_CPUTOPOLOGY_H
+
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#endif
+
+// =========================
+// CPU / NUMA 拓扑发现（不依赖 libnuma，直接读 sysfs）
+// 非 Linux 平台退化成“一个节点包含所有核心”
+// =========================
+struct NumaNode {
+    int id = 0;
+    std::vector<int> cpus; // 该节点上的逻辑 CPU 编号
+};
+
+class CpuTopology {
+public:
+    // 解析 sysfs 的 cpulist 格式，例如 "0-3,8-11,16"
+    static std::vector<int> parse_cpulist(const std::string& text) {
+        std::vector<int> cpus;
+        std::stringstream ss(text);
+        std::string part;
+        while (std::getline(ss, part, ',')) {
+            if (part.empty() || part == "\n") continue;
+            auto dash = part.find('-');
+            try {
+                if (dash == std::string::npos) {
+                    cpus.push_back(std::stoi(part));
+                } else {
+                    int lo = std::stoi(part.substr(0, dash));
+                    int hi = std::stoi(part.substr(dash + 1));
+                    for (int c = lo; c <= hi; ++c) cpus.push_back(c);
+                }
+            } catch (const std::exception&) {
+                // 格式不认识就跳过这一段
+            }
+        }
+        return cpus;
+    }
+
+    // 发现所有 NUMA 节点；读不到 sysfs 时返回单节点
+    static std::vector<NumaNode> discover() {
+        std::vector<NumaNode> nodes;
+#ifdef __linux__
+        const char* base = "/sys/devices/system/node";
+        if (DIR* dir = opendir(base)) {
+            while (dirent* ent = readdir(dir)) {
+                std::string name = ent->d_name;
+                if (name.size() <= 4 || name.compare(0, 4, "node") != 0) continue;
+                if (name.find_first_not_of("0123456789", 4) != std::string::npos) continue;
+
+                std::ifstream in(std::string(base) + "/" + name + "/cpulist");
+                std::string line;
+                if (!in || !std::getline(in, line)) continue;
+
+                NumaNode node;
+                node.id = std::stoi(name.substr(4));
+                node.cpus = parse_cpulist(line);
+                if (!node.cpus.empty()) nodes.push_back(std::move(node));
+            }
+            closedir(dir);
+        }
+        std::sort(nodes.begin(), nodes.end(),
+                  [](const NumaNode& a, const NumaNode& b) { return a.id < b.id; });
+#endif
+        if (nodes.empty()) {
+            NumaNode node;
+            unsigned int n = std::thread::hardware_concurrency();
+            if (n == 0) n = 1;
+            for (unsigned int c = 0; c < n; ++c) node.cpus.push_back(static_cast<int>(c));
+            nodes.push_back(std::move(node));
+        }
+        return nodes;
+    }
+
+    // 当前线程正跑在哪个逻辑 CPU 上，拿不到返回 -1
+    static int current_cpu() {
+#ifdef __linux__
+        return sched_getcpu();
+#else
+        return -1;
+#endif
+    }
+
+    // 把当前线程绑到 cpus 这组核心上；成功返回 true，不支持的平台返回 false
+    static bool pin_current_thread(const std::vector<int>& cpus) {
+        if (cpus.empty()) return false;
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c : cpus) {
+            if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        return false;
+#endif
+    }
+};
+
+#endif //CONCURRENCY_STUDY_CPUTOPOLOGY_H
@@ -0,0 +1,425 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_DATAGEN_H
+#define CONCURRENCY_STUDY_DATAGEN_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <memory>
+#include <new>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "ParallelSort.h"
+
+// =========================
+// 并行、可复现的批量数据生成
+// TurboSort 原来用一个 std::mt19937 串行地灌 5000 万个数，种子还是 random_device：
+// 准备数据比排序本身还慢，而且每次运行的输入都不一样。这里：
+//   1. 生成器用 xoshiro256**：每个数一次乘法几次移位，状态 32 字节，带 jump()（一次向前跳 2^128 步）
+//   2. 输出按固定大小的块（kChunk 个元素）切开，第 c 块用“从种子出发跳 c 次”的那条流。
+//      块的划分和线程数无关，所以不管几个工人、谁偷到哪块，结果逐位相同；生成 n 个和生成 2n 个的前 n 个也相同
+//   3. 分布（均匀整数 / 均匀实数 / 正态 / Zipf）都自己实现，不用 std::*_distribution
+//      ——标准库的分布算法由实现决定，换个编译器同一个种子就是另一组数
+// 数据直接写进调用者给的缓冲区，或者写进内存映射文件（不经过中间 vector）
+// =========================
+
+// xoshiro256** (Blackman & Vigna)。满足 UniformRandomBitGenerator，也能喂给标准库的分布
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) {
+        // 用 splitmix64 把一个 64 位种子摊成 4 个字，相近的种子也得到毫不相关的状态
+        for (auto& w : s_) {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            w = z ^ (z >> 31);
+        }
+        if ((s_[0] | s_[1] | s_[2] | s_[3]) == 0) s_[0] = 1; // 全零是唯一的不动点
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t result = rotl(s_[1] * 5, 7) * 9;
+        uint64_t t = s_[1] << 17;
+        s_[2] ^= s_[0];
+        s_[3] ^= s_[1];
+        s_[1] ^= s_[2];
+        s_[0] ^= s_[3];
+        s_[2] ^= t;
+        s_[3] = rotl(s_[3], 45);
+        return result;
+    }
+
+    // [0, 1) 上的 double：取高 53 位
+    double next_double() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+    // 等价于调用 2^128 次 operator()：跳出来的各条流互不重叠，每条都够用 2^128 个数
+    void jump() {
+        static constexpr uint64_t kJump[] = {0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull,
+                                             0x39ABDC4529B1661Cull};
+        uint64_t t[4] = {0, 0, 0, 0};
+        for (uint64_t word : kJump) {
+            for (int b = 0; b < 64; ++b) {
+                if (word & (uint64_t(1) << b)) {
+                    for (int i = 0; i < 4; ++i) t[i] ^= s_[i];
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) s_[i] = t[i];
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t s_[4]{};
+};
+
+// =========================
+// 分布：可复制的函数对象，dist(gen) 返回一个值。每块开始时从原型复制一份，块内状态（正态的备用值）不会串到别的块
+// =========================
+
+namespace datagen_detail {
+
+// 64×64 → 128 位乘法，返回高 64 位，低 64 位写进 lo。没有 __int128 时拆成 32 位算，结果一样
+inline uint64_t mul_hi(uint64_t a, uint64_t b, uint64_t& lo) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 m = static_cast<unsigned __int128>(a) * b;
+    lo = static_cast<uint64_t>(m);
+    return static_cast<uint64_t>(m >> 64);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFull, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFull, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFull) + (hl & 0xFFFFFFFFull);
+    lo = (mid << 32) | (ll & 0xFFFFFFFFull);
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
+}
+
+} // namespace datagen_detail
+
+// [lo, hi] 上的均匀整数，无偏。Lemire 的乘法取高位：绝大多数情况下一次乘法，不做除法
+template<typename T>
+struct UniformInt {
+    static_assert(std::is_integral<T>::value, "UniformInt 需要整数类型");
+
+    T lo, hi;
+
+    UniformInt(T lo_, T hi_) : lo(lo_), hi(hi_) {
+        if (hi < lo) throw std::invalid_argument("UniformInt: hi < lo");
+    }
+
+    T operator()(Xoshiro256& g) const {
+        // 区间长度 - 1 用无符号算，int64 的整个范围也不会溢出；range == 0 表示 2^64 种取值
+        uint64_t range = static_cast<uint64_t>(hi) - static_cast<uint64_t>(lo) + 1;
+        uint64_t x = g();
+        if (range != 0) {
+            uint64_t low;
+            x = datagen_detail::mul_hi(x, range, low);
+            if (low < range) {
+                uint64_t threshold = (0 - range) % range; // 2^64 mod range：落在这一截里的要扔掉重抽
+                while (low < threshold) x = datagen_detail::mul_hi(g(), range, low);
+            }
+        }
+        return static_cast<T>(static_cast<uint64_t>(lo) + x);
+    }
+};
+
+// [lo, hi) 上的均匀实数
+template<typename T>
+struct UniformReal {
+    static_assert(std::is_floating_point<T>::value, "UniformReal 需要浮点类型");
+
+    T lo, hi;
+
+    UniformReal(T lo_, T hi_) : lo(lo_), hi(hi_) {}
+
+    T operator()(Xoshiro256& g) const { return static_cast<T>(lo + (hi - lo) * g.next_double()); }
+};
+
+// 正态分布：Marsaglia 极坐标法，一次接受产出两个值，第二个留到下一次
+template<typename T>
+struct Normal {
+    static_assert(std::is_floating_point<T>::value, "Normal 需要浮点类型");
+
+    T mean, stddev;
+
+    Normal(T mean_, T stddev_) : mean(mean_), stddev(stddev_) {}
+
+    T operator()(Xoshiro256& g) {
+        if (has_spare_) {
+            has_spare_ = false;
+            return static_cast<T>(mean + stddev * spare_);
+        }
+        double u, v, s;
+        do {
+            u = 2.0 * g.next_double() - 1.0;
+            v = 2.0 * g.next_double() - 1.0;
+            s = u * u + v * v;
+        } while (s >= 1.0 || s == 0.0);
+        double f = std::sqrt(-2.0 * std::log(s) / s);
+        spare_ = v * f;
+        has_spare_ = true;
+        return static_cast<T>(mean + stddev * (u * f));
+    }
+
+private:
+    double spare_ = 0;
+    bool has_spare_ = false;
+};
+
+// Zipf 分布：取值 1..n，P(k) ∝ 1 / k^s（s > 0）。
+// Hörmann & Derflinger 的拒绝-反演法：不建累积分布表，O(1) 内存，n 可以是几十亿；平均不到 1.1 次就接受
+template<typename T>
+struct Zipf {
+    static_assert(std::is_integral<T>::value, "Zipf 需要整数类型");
+
+    Zipf(uint64_t n, double s) : n_(n), s_(s) {
+        if (n == 0 || !(s > 0)) throw std::invalid_argument("Zipf: 需要 n >= 1 且 s > 0");
+        h_integral_x1_ = h_integral(1.5) - 1.0;
+        h_integral_n_ = h_integral(static_cast<double>(n) + 0.5);
+        cut_ = 2.0 - h_integral_inverse(h_integral(2.5) - h(2.0));
+    }
+
+    T operator()(Xoshiro256& g) const {
+        for (;;) {
+            double u = h_integral_n_ + g.next_double() * (h_integral_x1_ - h_integral_n_);
+            double x = h_integral_inverse(u);
+            double kf = std::floor(x + 0.5);
+            if (kf < 1.0) kf = 1.0;
+            if (kf > static_cast<double>(n_)) kf = static_cast<double>(n_);
+            // 先用便宜的条件快速接受（大多数落在这里），不行再和精确的积分比
+            if (kf - x <= cut_ || u >= h_integral(kf + 0.5) - h(kf)) return static_cast<T>(kf);
+        }
+    }
+
+private:
+    // h(x) = x^-s 的原函数：s = 1 时是 log(x)，写成 expm1 / log1p 的形式在 s 接近 1 时也不丢精度
+    double h(double x) const { return std::exp(-s_ * std::log(x)); }
+
+    double h_integral(double x) const {
+        double lx = std::log(x);
+        return helper2((1.0 - s_) * lx) * lx;
+    }
+
+    double h_integral_inverse(double x) const {
+        double t = x * (1.0 - s_);
+        if (t < -1.0) t = -1.0; // 舍入误差可能让它略小于 -1
+        return std::exp(helper1(t) * x);
+    }
+
+    // log1p(x) / x，x → 0 时取极限 1
+    static double helper1(double x) { return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x / 3.0); }
+
+    // expm1(x) / x，x → 0 时取极限 1
+    static double helper2(double x) { return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0); }
+
+    uint64_t n_;
+    double s_;
+    double h_integral_x1_ = 0, h_integral_n_ = 0, cut_ = 0;
+};
+
+namespace datagen_detail {
+
+// vector(n) 不做值初始化的分配器：平凡类型的元素留着不写，第一次写发生在并行生成的各块里，
+// 缺页也摊到各工人上；std::vector<T>(n) 会先在调用线程里把整块内存串行清零一遍
+template<typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+    template<typename U>
+    struct rebind { using other = DefaultInitAllocator<U>; };
+
+    DefaultInitAllocator() = default;
+    template<typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+    template<typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) { ::new (static_cast<void*>(p)) U; }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+};
+
+// 块大小是输出格式的一部分：改了它，同一个种子生成的数据就变了
+constexpr size_t kChunk = size_t(1) << 16;
+
+// 第 c 块的流 = 从种子出发 jump() c 次。跳一次约 256 次 next，5000 万个元素才 763 块，串行算完也只要零点几毫秒
+inline std::vector<Xoshiro256> chunk_streams(uint64_t seed, size_t chunks) {
+    std::vector<Xoshiro256> streams;
+    streams.reserve(chunks);
+    Xoshiro256 g(seed);
+    for (size_t c = 0; c < chunks; ++c) {
+        streams.push_back(g);
+        g.jump();
+    }
+    return streams;
+}
+
+// 分布可以只要生成器 dist(g)，也可以再要全局下标 dist(g, i)（有序 / 锯齿之类和位置有关的输入）
+template<typename T, typename Dist>
+void fill_chunk(T* out, size_t begin, size_t end, Xoshiro256 g, Dist dist) {
+    for (size_t i = begin; i < end; ++i) {
+        if constexpr (std::is_invocable<Dist&, Xoshiro256&, size_t>::value) {
+            out[i] = static_cast<T>(dist(g, i));
+        } else {
+            out[i] = static_cast<T>(dist(g));
+        }
+    }
+}
+
+// 输出文件的内存映射：构造时建文件、定长度、映射成可写；析构时解除映射（脏页由系统写回）
+class MappedOutput {
+public:
+    MappedOutput(const std::filesystem::path& path, size_t bytes) : bytes_(bytes) {
+#ifdef _WIN32
+        file_ = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) fail("打开输出文件失败: " + path.string());
+        if (bytes == 0) return;
+        auto size = static_cast<unsigned long long>(bytes);
+        mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READWRITE, static_cast<DWORD>(size >> 32),
+                                      static_cast<DWORD>(size & 0xFFFFFFFFull), nullptr);
+        if (mapping_ == nullptr) fail("创建文件映射失败: " + path.string());
+        data_ = MapViewOfFile(mapping_, FILE_MAP_WRITE, 0, 0, bytes);
+        if (data_ == nullptr) fail("映射输出文件失败: " + path.string());
+#else
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) fail("打开输出文件失败: " + path.string());
+        if (bytes == 0) return;
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) fail("设置输出文件长度失败: " + path.string());
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) fail("映射输出文件失败: " + path.string());
+        data_ = p;
+#endif
+    }
+
+    MappedOutput(const MappedOutput&) = delete;
+    MappedOutput& operator=(const MappedOutput&) = delete;
+
+    ~MappedOutput() { release(); }
+
+    void* data() const { return data_; }
+
+private:
+    [[noreturn]] void fail(const std::string& what) {
+#ifdef _WIN32
+        std::error_code ec(static_cast<int>(GetLastError()), std::system_category());
+#else
+        std::error_code ec(errno, std::generic_category());
+#endif
+        release();
+        throw std::system_error(ec, what);
+    }
+
+    void release() {
+#ifdef _WIN32
+        if (data_ != nullptr) UnmapViewOfFile(data_);
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_ != nullptr) ::munmap(data_, bytes_);
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        data_ = nullptr;
+    }
+
+    size_t bytes_;
+    void* data_ = nullptr;
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace datagen_detail
+
+// =========================
+// 对外接口
+// =========================
+
+// 往 out[0, n) 里并行生成 n 个数。结果只由 (seed, dist, 下标) 决定，和池子里有几个工人无关
+template<typename T, typename Dist>
+void parallel_generate(WorkStealingPool& pool, T* out, size_t n, uint64_t seed, Dist dist) {
+    if (n == 0) return;
+    size_t chunks = (n + datagen_detail::kChunk - 1) / datagen_detail::kChunk;
+    std::vector<Xoshiro256> streams = datagen_detail::chunk_streams(seed, chunks);
+    auto body = [&](size_t c) {
+        size_t begin = c * datagen_detail::kChunk;
+        size_t end = (std::min)(n, begin + datagen_detail::kChunk);
+        datagen_detail::fill_chunk(out, begin, end, streams[c], dist);
+    };
+    if (pool.thread_count() <= 1 || chunks == 1) {
+        for (size_t c = 0; c < chunks; ++c) body(c);
+        return;
+    }
+    pool.run([&]() { sort_detail::fork_each(pool, 0, chunks, body); });
+}
+
+template<typename T, typename Dist>
+void parallel_generate(T* out, size_t n, uint64_t seed, Dist dist) {
+    parallel_generate(default_work_stealing_pool(), out, n, seed, std::move(dist));
+}
+
+// 便捷版本：新建一个 vector 返回。用不清零的分配器，元素只被并行生成写一遍
+template<typename T>
+using RandomVector = std::vector<T, datagen_detail::DefaultInitAllocator<T>>;
+
+template<typename T, typename Dist>
+RandomVector<T> make_random_vector(WorkStealingPool& pool, size_t n, uint64_t seed, Dist dist) {
+    RandomVector<T> v(n);
+    parallel_generate(pool, v.data(), n, seed, std::move(dist));
+    return v;
+}
+
+template<typename T, typename Dist>
+RandomVector<T> make_random_vector(size_t n, uint64_t seed, Dist dist) {
+    return make_random_vector<T>(default_work_stealing_pool(), n, seed, std::move(dist));
+}
+
+// 直接生成到文件：T 的原始字节紧挨着排（和 external_sort 的输入格式一样），各块并行写进映射区，不占额外内存
+template<typename T, typename Dist>
+void parallel_generate_file(WorkStealingPool& pool, const std::filesystem::path& path, size_t n, uint64_t seed,
+                            Dist dist) {
+    static_assert(std::is_trivially_copyable<T>::value, "写进文件的类型必须可平凡复制");
+    datagen_detail::MappedOutput file(path, n * sizeof(T));
+    parallel_generate(pool, static_cast<T*>(file.data()), n, seed, std::move(dist));
+}
+
+template<typename T, typename Dist>
+void parallel_generate_file(const std::filesystem::path& path, size_t n, uint64_t seed, Dist dist) {
+    parallel_generate_file<T>(default_work_stealing_pool(), path, n, seed, std::move(dist));
+}
+
+#endif //CONCURRENCY_STUDY_DATAGEN_H
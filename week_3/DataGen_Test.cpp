@@ -0,0 +1,126 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "DataGen.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 用 1 / 2 / 4 / 8 个工人各生成一遍，和单线程的结果逐个比较
+template<typename T, typename Dist>
+bool same_for_all_pools(std::vector<std::unique_ptr<WorkStealingPool>>& pools, size_t n, uint64_t seed, const Dist& dist) {
+    auto expect = make_random_vector<T>(*pools[0], n, seed, dist);
+    for (size_t i = 1; i < pools.size(); ++i) {
+        if (make_random_vector<T>(*pools[i], n, seed, dist) != expect) return false;
+    }
+    return true;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    std::cout << std::fixed << std::setprecision(2);
+    WorkStealingPool& pool = default_work_stealing_pool();
+    std::cout << "工人数: " << pool.thread_count() << std::endl;
+
+    // 1. 结果和线程数无关
+    {
+        std::vector<std::unique_ptr<WorkStealingPool>> pools;
+        for (size_t t : {1, 2, 4, 8}) pools.push_back(std::make_unique<WorkStealingPool>(t));
+        const size_t n = 3000017; // 故意不是块大小的整数倍
+        bool ok = same_for_all_pools<int>(pools, n, 42, UniformInt<int>(1, 1000000000)) &&
+                  same_for_all_pools<double>(pools, n, 42, Normal<double>(0.0, 1.0)) &&
+                  same_for_all_pools<int>(pools, n, 42, Zipf<int>(1000000, 1.0));
+        std::cout << "1 / 2 / 4 / 8 个工人: " << (ok ? "逐位相同" : "结果不一致!") << std::endl;
+
+        // 前缀稳定：生成 n 个的前 n/2 个 == 直接生成 n/2 个
+        auto whole = make_random_vector<uint64_t>(pool, n, 7, UniformInt<uint64_t>(0, UINT64_MAX));
+        auto half = make_random_vector<uint64_t>(pool, n / 2, 7, UniformInt<uint64_t>(0, UINT64_MAX));
+        std::cout << "前缀稳定: " << (std::equal(half.begin(), half.end(), whole.begin()) ? "是" : "否!") << std::endl;
+    }
+
+    // 2. 5000 万个 int：TurboSort 原来的写法 vs 并行生成
+    const size_t N = 50000000;
+    {
+        std::vector<int> data(N);
+        auto start = Clock::now();
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> dis(1, 1000000000);
+        for (auto& x : data) x = dis(gen);
+        double base = ms_since(start);
+
+        start = Clock::now();
+        parallel_generate(pool, data.data(), N, 42, UniformInt<int>(1, 1000000000));
+        double ms = ms_since(start);
+        auto [lo, hi] = std::minmax_element(data.begin(), data.end());
+        std::cout << "5000 万 int: mt19937 串行 " << base << " ms，parallel_generate " << ms << " ms (" << base / ms
+                  << "x)，取值范围 [" << *lo << ", " << *hi << "]" << std::endl;
+    }
+
+    // 3. 分布是否像样：正态的均值 / 标准差，Zipf 第 1 名的频率（s = 1 时 ≈ 1 / H(n)）
+    {
+        std::vector<double> v(N);
+        auto start = Clock::now();
+        parallel_generate(pool, v.data(), N, 1, Normal<double>(10.0, 2.0));
+        double ms = ms_since(start);
+        double sum = 0, sq = 0;
+        for (double x : v) sum += x, sq += x * x;
+        double mean = sum / static_cast<double>(N);
+        std::cout << "正态 N(10, 2): " << ms << " ms，均值 " << std::setprecision(4)
+                  << mean << "，标准差 " << std::sqrt(sq / static_cast<double>(N) - mean * mean) << std::endl;
+
+        std::vector<uint32_t> z(N);
+        const uint64_t ranks = 1000000;
+        start = Clock::now();
+        parallel_generate(pool, z.data(), N, 1, Zipf<uint32_t>(ranks, 1.0));
+        ms = ms_since(start);
+        double harmonic = 0;
+        for (uint64_t r = 1; r <= ranks; ++r) harmonic += 1.0 / static_cast<double>(r);
+        double top = static_cast<double>(std::count(z.begin(), z.end(), 1u)) / static_cast<double>(N);
+        std::cout << std::setprecision(2) << "Zipf(100 万, 1.0): " << ms << " ms，第 1 名频率 " << std::setprecision(4) << top
+                  << "（理论 " << 1.0 / harmonic << "）" << std::endl;
+    }
+
+    // 4. 直接写进内存映射文件，读回来和内存里生成的比
+    {
+        auto path = std::filesystem::temp_directory_path() / "datagen_test.bin";
+        const size_t n = 10000000;
+        auto start = Clock::now();
+        parallel_generate_file<int64_t>(pool, path, n, 99, UniformInt<int64_t>(-1000000, 1000000));
+        double ms = ms_since(start);
+
+        std::vector<int64_t> back(n);
+        {
+            std::ifstream in(path, std::ios::binary);
+            in.read(reinterpret_cast<char*>(back.data()), static_cast<std::streamsize>(n * sizeof(int64_t)));
+        }
+        std::filesystem::remove(path);
+        auto expect = make_random_vector<int64_t>(pool, n, 99, UniformInt<int64_t>(-1000000, 1000000));
+        bool ok = std::equal(back.begin(), back.end(), expect.begin(), expect.end());
+        std::cout << std::setprecision(2) << "1000 万 int64 写进映射文件: " << ms << " ms" << (ok ? "，读回一致" : " 读回不一致!")
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,246 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_DISRUPTOR_H
+#define CONCURRENCY_STUDY_DISRUPTOR_H
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <initializer_list>
+
+// =========================
+// Disruptor 风格的环：消息槽一开始就全部分配好，之后只原地复用
+//   生产者：claim() 领一个序号 -> 直接在槽里填消息 -> publish(序号)
+//   消费者：等到某个序号可读 -> 原地读（不拷贝出来）-> release(序号) 把槽还回去
+// SafeQueue::produce(T) 要把消息移进队列、consume 再移出来；消息大的时候这两次拷贝才是大头，
+// 这里一条消息从头到尾只在它自己的槽里待着，每条消息没有分配也没有拷贝
+//
+// 消费者可以分组、有依赖：比如“落盘”和“复制”两个消费者并行读，“业务处理”要等它们都处理完某个序号才能读。
+// 生产者要等所有消费者都处理完一个槽，才能把它分给新消息（环绕）
+// =========================
+
+enum class ProducerMode {
+    Single, // 只有一个线程 claim/publish：序号不需要原子 RMW
+    Multi   // 多个线程同时 claim：fetch_add 领序号，每个槽另有一个“已发布”标记
+};
+
+template<typename T>
+class Disruptor {
+public:
+    using Sequence = int64_t;
+
+    // 消费者：自己的进度 sequence_（已经处理完的最大序号）+ 它依赖的上游
+    class Consumer {
+    public:
+        // 最新已处理的序号，-1 表示还没处理过
+        Sequence sequence() const { return sequence_.load(std::memory_order_acquire); }
+
+        // 等到 next 可读，返回当前能读到的最大序号（>= next，可以一次处理一批）
+        // 环已经 halt() 而且再也不会有新消息时返回 next - 1
+        Sequence wait_for(Sequence next) {
+            for (int round = 0;; ++round) {
+                Sequence avail = ring_->available_for(*this, next);
+                if (avail >= next) return avail;
+                if (finished()) {
+                    avail = ring_->available_for(*this, next); // 停止前最后看一眼
+                    return avail >= next ? avail : next - 1;
+                }
+                backoff(round);
+            }
+        }
+
+        // 原地访问消息
+        const T& operator[](Sequence seq) const { return ring_->slot(seq); }
+
+        // 处理完了 [.., seq]：这些槽下游消费者可以读，全部消费者都放过之后生产者可以复用
+        void release(Sequence seq) { sequence_.store(seq, std::memory_order_release); }
+
+        // 常用的消费循环：handler(const T& msg, Sequence seq, bool end_of_batch)
+        // 一直跑到环 halt() 并且能读的都读完；返回处理的消息数
+        template<typename Handler>
+        uint64_t process(Handler&& handler) {
+            uint64_t count = 0;
+            Sequence next = sequence_.load(std::memory_order_relaxed) + 1;
+            while (true) {
+                Sequence avail = wait_for(next);
+                if (avail < next) break;
+                for (Sequence s = next; s <= avail; ++s) {
+                    handler(ring_->slot(s), s, s == avail);
+                }
+                count += static_cast<uint64_t>(avail - next + 1);
+                release(avail); // 整批处理完才发布一次进度
+                next = avail + 1;
+            }
+            done_.store(true, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        friend class Disruptor;
+
+        // 上游都结束了、环也 halt 了，才算再也等不到新消息
+        bool finished() const {
+            if (!ring_->halted_.load(std::memory_order_acquire)) return false;
+            for (const Consumer* dep : deps_) {
+                if (!dep->done_.load(std::memory_order_acquire)) return false;
+            }
+            return true;
+        }
+
+        alignas(64) std::atomic<Sequence> sequence_{-1};
+        std::atomic<bool> done_{false};
+        Disruptor* ring_ = nullptr;
+        std::vector<const Consumer*> deps_;
+    };
+
+    // capacity 会向上取到 2 的幂；T 的默认构造在这里一次性完成
+    explicit Disruptor(size_t capacity, ProducerMode mode = ProducerMode::Single) : mode_(mode) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        while ((size_t{1} << shift_) < cap) ++shift_;
+        slots_.reset(new T[cap]);
+        if (mode_ == ProducerMode::Multi) {
+            published_.reset(new std::atomic<int32_t>[cap]);
+            for (size_t i = 0; i < cap; ++i) published_[i].store(-1, std::memory_order_relaxed);
+        }
+    }
+
+    Disruptor(const Disruptor&) = delete;
+    Disruptor& operator=(const Disruptor&) = delete;
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // 注册消费者（必须在开始生产之前）：after 里的消费者处理完一个序号，这个消费者才能读它
+    Consumer& add_consumer(std::initializer_list<Consumer*> after = {}) {
+        consumers_.emplace_back();
+        Consumer& c = consumers_.back();
+        c.ring_ = this;
+        for (Consumer* dep : after) c.deps_.push_back(dep);
+        gating_.push_back(&c);
+        return c;
+    }
+
+    // ---------- 生产者 ----------
+
+    // 领 n 个连续序号，返回最后一个；槽被消费者占着时在这里等
+    Sequence claim(size_t n = 1) {
+        Sequence hi;
+        if (mode_ == ProducerMode::Single) {
+            hi = next_claim_ + static_cast<Sequence>(n);
+            next_claim_ = hi;
+        } else {
+            hi = claimed_.fetch_add(static_cast<Sequence>(n), std::memory_order_relaxed) + static_cast<Sequence>(n);
+        }
+        // 要复用的最老的槽是 hi - capacity，所有消费者都越过它才行
+        Sequence wrap = hi - static_cast<Sequence>(capacity());
+        if (wrap > cached_gate_.load(std::memory_order_relaxed)) {
+            for (int round = 0;; ++round) {
+                Sequence gate = min_gating();
+                cached_gate_.store(gate, std::memory_order_relaxed);
+                if (wrap <= gate) break;
+                backoff(round);
+            }
+        }
+        return hi;
+    }
+
+    // 领到的槽：直接在里面填消息
+    T& operator[](Sequence seq) { return slot(seq); }
+
+    void publish(Sequence seq) { publish(seq, seq); }
+
+    // 发布 [lo, hi]
+    void publish(Sequence lo, Sequence hi) {
+        if (mode_ == ProducerMode::Single) {
+            cursor_.store(hi, std::memory_order_release);
+        } else {
+            for (Sequence s = lo; s <= hi; ++s) {
+                published_[static_cast<size_t>(s) & mask_].store(round_of(s), std::memory_order_release);
+            }
+        }
+    }
+
+    // claim + 填 + publish 一步到位：fill(T& slot, Sequence seq)
+    template<typename Fill>
+    Sequence produce(Fill&& fill) {
+        Sequence seq = claim();
+        fill(slot(seq), seq);
+        publish(seq);
+        return seq;
+    }
+
+    // 生产结束：消费者把已经发布的处理完就退出 process()
+    // 多生产者时要等所有生产者都 publish 完再调
+    void halt() { halted_.store(true, std::memory_order_release); }
+
+private:
+    T& slot(Sequence seq) { return slots_[static_cast<size_t>(seq) & mask_]; }
+
+    int32_t round_of(Sequence seq) const { return static_cast<int32_t>(seq >> shift_); }
+
+    // 消费者 c 从 next 开始最多能读到哪
+    Sequence available_for(const Consumer& c, Sequence next) const {
+        if (!c.deps_.empty()) {
+            // 有上游：上游处理过的一定已经发布了，取它们中最慢的
+            Sequence m = std::numeric_limits<Sequence>::max();
+            for (const Consumer* dep : c.deps_) {
+                Sequence s = dep->sequence();
+                if (s < m) m = s;
+            }
+            return m;
+        }
+        if (mode_ == ProducerMode::Single) return cursor_.load(std::memory_order_acquire);
+
+        // 多生产者：领到的不一定都发布了，从 next 往后找连续已发布的一段
+        Sequence hi = claimed_.load(std::memory_order_acquire);
+        Sequence s = next;
+        while (s <= hi &&
+               published_[static_cast<size_t>(s) & mask_].load(std::memory_order_acquire) == round_of(s)) {
+            ++s;
+        }
+        return s - 1;
+    }
+
+    Sequence min_gating() const {
+        Sequence m = std::numeric_limits<Sequence>::max();
+        for (const Consumer* c : gating_) {
+            Sequence s = c->sequence();
+            if (s < m) m = s;
+        }
+        return m; // 没有消费者时不设限
+    }
+
+    // 分阶段退避：先空转，再让出时间片，最后短睡，不会一直烧满一个核
+    static void backoff(int round) {
+        if (round < 64) return;
+        if (round < 256) {
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    ProducerMode mode_;
+    size_t mask_ = 0;
+    int shift_ = 0;
+    std::unique_ptr<T[]> slots_;
+    std::unique_ptr<std::atomic<int32_t>[]> published_; // 多生产者：每个槽最后发布的是第几圈
+    std::deque<Consumer> consumers_;                     // deque：扩容时已有元素地址不变
+    std::vector<const Consumer*> gating_;
+
+    alignas(64) std::atomic<Sequence> cursor_{-1};    // 单生产者：已发布的最大序号
+    alignas(64) std::atomic<Sequence> claimed_{-1};   // 多生产者：已领走的最大序号
+    alignas(64) Sequence next_claim_ = -1;            // 单生产者：只有生产者线程用
+    std::atomic<Sequence> cached_gate_{-1};           // 上次看到的最慢消费者进度
+    alignas(64) std::atomic<bool> halted_{false};
+};
+
+#endif //CONCURRENCY_STUDY_DISRUPTOR_H
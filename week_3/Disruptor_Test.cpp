@@ -0,0 +1,119 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include "Disruptor.h"
+#include "SafeQueue.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// 一条“大消息”：4KB 负载
+struct Message {
+    uint64_t id = 0;
+    uint32_t length = 0;
+    char payload[4096] = {};
+};
+
+uint64_t checksum(const Message& m) {
+    uint64_t h = m.id;
+    for (uint32_t i = 0; i < m.length; i += 64) h = h * 31 + static_cast<unsigned char>(m.payload[i]);
+    return h;
+}
+
+void fill(Message& m, uint64_t id) {
+    m.id = id;
+    m.length = sizeof(m.payload);
+    m.payload[0] = static_cast<char>(id);
+    m.payload[m.length - 64] = static_cast<char>(id >> 8);
+}
+
+double mps(uint64_t n, Clock::time_point start) {
+    return static_cast<double>(n) / std::chrono::duration<double>(Clock::now() - start).count() / 1e6;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    const uint64_t N = 1000000;
+
+    // 1. 基准：SafeQueue<Message>，进队拷贝一次、出队再拷贝一次
+    {
+        SafeQueue<Message> q(1024);
+        uint64_t sum = 0;
+        auto start = Clock::now();
+        std::thread consumer([&]() {
+            Message m;
+            while (q.consume(m)) sum += checksum(m);
+        });
+        Message m;
+        for (uint64_t i = 0; i < N; ++i) {
+            fill(m, i);
+            q.produce(m);
+        }
+        q.close();
+        consumer.join();
+        std::cout << "SafeQueue<Message>       : " << mps(N, start) << " M msg/s (checksum " << sum % 1000 << ")" << std::endl;
+    }
+
+    // 2. Disruptor：生产者原地填槽；journal 和 replicate 并行读，business 等它们都处理完再读
+    {
+        Disruptor<Message> ring(1024);
+        auto& journal = ring.add_consumer();
+        auto& replicate = ring.add_consumer();
+        auto& business = ring.add_consumer({&journal, &replicate});
+
+        uint64_t j_sum = 0, r_count = 0, b_sum = 0;
+        auto start = Clock::now();
+        std::thread tj([&]() { journal.process([&](const Message& m, int64_t, bool) { j_sum += checksum(m); }); });
+        std::thread tr([&]() { replicate.process([&](const Message& m, int64_t, bool) { r_count += m.length > 0; }); });
+        std::thread tb([&]() { business.process([&](const Message& m, int64_t, bool) { b_sum += checksum(m); }); });
+
+        for (uint64_t i = 0; i < N; ++i) {
+            ring.produce([i](Message& m, int64_t) { fill(m, i); });
+        }
+        ring.halt();
+        tj.join();
+        tr.join();
+        tb.join();
+        std::cout << "Disruptor 1P -> 2 -> 1    : " << mps(N, start) << " M msg/s (checksum " << b_sum % 1000
+                  << (j_sum == b_sum && r_count == N ? "，三个消费者一致" : "，不一致!") << ")" << std::endl;
+    }
+
+    // 3. 多生产者：两个线程同时 claim/publish，消费者按序号顺序读到全部消息
+    {
+        Disruptor<Message> ring(1024, ProducerMode::Multi);
+        auto& consumer = ring.add_consumer();
+
+        uint64_t count = 0, id_sum = 0;
+        auto start = Clock::now();
+        std::thread tc([&]() {
+            count = consumer.process([&](const Message& m, int64_t, bool) { id_sum += m.id; });
+        });
+        std::vector<std::thread> producers;
+        for (uint64_t p = 0; p < 2; ++p) {
+            producers.emplace_back([&ring, p, N]() {
+                for (uint64_t i = p; i < N; i += 2) ring.produce([i](Message& m, int64_t) { fill(m, i); });
+            });
+        }
+        for (auto& t : producers) t.join();
+        ring.halt();
+        tc.join();
+        std::cout << "Disruptor 2P -> 1 (Multi) : " << mps(N, start) << " M msg/s ("
+                  << (count == N && id_sum == N * (N - 1) / 2 ? "全部收到" : "丢消息!") << ")" << std::endl;
+    }
+
+    return 0;
+}
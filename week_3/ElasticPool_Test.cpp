@@ -0,0 +1,78 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include "ThreadPool.h"
+
+// 仅在 Windows 下包含 windows.h 并设置控制台编码
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 模拟一波突发流量：短时间内塞进去一堆 50ms 的任务
+void burst(ThreadPool& pool, int count) {
+    for (int i = 0; i < count; ++i) {
+        pool.enqueue([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        });
+    }
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    // 最少 2 个工人，最多 8 个；排队超过 20ms 或积压 4 个以上就扩容，空闲 1s 退休
+    ThreadPoolOptions opt = ThreadPoolOptions::elastic(2, 8);
+    opt.scale_up_queue_depth = 4;
+    opt.scale_up_wait = std::chrono::milliseconds(20);
+    opt.idle_timeout = std::chrono::seconds(1);
+
+    ThreadPool pool(opt);
+    std::cout << "初始线程数: " << pool.thread_count() << std::endl;
+
+    // 1. 突发流量 -> 扩容
+    burst(pool, 80);
+    for (int i = 0; i < 5; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        std::cout << "[突发中] 线程数: " << pool.thread_count()
+                  << "  队列积压: " << pool.queue_size() << std::endl;
+    }
+
+    // 2. 流量消失 -> 空闲超时后缩回 min_threads
+    std::this_thread::sleep_for(std::chrono::seconds(3));
+    std::cout << "[空闲后] 线程数: " << pool.thread_count() << std::endl;
+
+    // 3. 阻塞补偿：两个任务都声明自己要阻塞，线程池临时补人，其它任务不会被饿死
+    for (int i = 0; i < 2; ++i) {
+        pool.enqueue([&pool] {
+            ThreadPool::BlockingScope guard(pool);
+            std::this_thread::sleep_for(std::chrono::milliseconds(500)); // 模拟阻塞 IO
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<bool> done{false};
+    pool.enqueue([&done] { done = true; });
+    while (!done) std::this_thread::yield();
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+    std::cout << "[阻塞补偿] 线程数: " << pool.thread_count()
+              << "  普通任务等待: " << waited.count() << " ms" << std::endl;
+
+    // 不是工人的线程声明阻塞：不算数，也不补人
+    {
+        size_t threads = pool.thread_count(), blocked = pool.blocked_count();
+        ThreadPool::BlockingScope guard(pool);
+        std::cout << "[main 声明阻塞] 阻塞计数: " << blocked << " -> " << pool.blocked_count()
+                  << "  线程数: " << threads << " -> " << pool.thread_count() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,417 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_EXTERNALSORT_H
+#define CONCURRENCY_STUDY_EXTERNALSORT_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include "ParallelSort.h"
+#include "Future.h"
+
+// =========================
+// 外部排序：数据比内存大的时候
+// parallel_merge_sort 要求整个数组都在内存里；这里只占用 memory_bytes 这么多缓冲：
+//   1. 生成顺串：按块读入输入文件，每块用 parallel_merge_sort_buffered 并行排好，写成一个临时顺串文件。
+//      三块缓冲轮转：读第 i+1 块、排第 i 块、写第 i-1 块同时进行
+//   2. 多路归并：败者树做 k 路归并，每路一对读缓冲、输出一对写缓冲（双缓冲），
+//      I/O 线程读写其中一块的时候，归并线程在另一块上干活
+// 顺串太多、每路分到的缓冲小于 min_block_bytes 时（块太小磁盘就成了随机读），先分组归并成更少的顺串，再做最后一趟
+// 文件格式：T 的原始字节紧挨着排（T 必须可平凡复制）；读写都在一个两线程的 I/O 池里，一个读一个写
+// =========================
+
+struct ExternalSortOptions {
+    size_t memory_bytes = size_t(256) << 20; // 所有缓冲加起来的上限
+    std::string temp_dir;                    // 顺串文件放哪；空 = 系统临时目录
+    size_t min_block_bytes = size_t(1) << 20; // 归并时每路读缓冲的下限，决定一趟最多归并几路
+};
+
+struct ExternalSortStats {
+    uint64_t elements = 0;
+    size_t runs = 0;         // 第一阶段生成的顺串数
+    size_t merge_passes = 0; // 归并趟数（只有一个顺串时为 0）
+    double run_seconds = 0;
+    double merge_seconds = 0;
+};
+
+namespace external_detail {
+
+using Clock = std::chrono::steady_clock;
+
+inline double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// FILE* 的 RAII 包装：打不开、读写出错都抛 runtime_error
+class File {
+public:
+    File(const std::string& path, const char* mode) : path_(path), f_(std::fopen(path.c_str(), mode)) {
+        if (!f_) throw std::runtime_error("external_sort: 打不开文件 " + path);
+        std::setvbuf(f_, nullptr, _IONBF, 0); // 每次都是整块读写，stdio 的缓冲只会多拷一遍
+    }
+    ~File() {
+        if (f_) std::fclose(f_);
+    }
+    File(const File&) = delete;
+    File& operator=(const File&) = delete;
+
+    // 读满 bytes 或读到文件尾，返回实际读到的字节数
+    size_t read(void* dst, size_t bytes) {
+        size_t got = std::fread(dst, 1, bytes, f_);
+        if (got < bytes && std::ferror(f_)) throw std::runtime_error("external_sort: 读文件出错 " + path_);
+        return got;
+    }
+
+    void write(const void* src, size_t bytes) {
+        if (std::fwrite(src, 1, bytes, f_) != bytes) throw std::runtime_error("external_sort: 写文件出错 " + path_);
+    }
+
+    // 显式关闭：fclose 才会报告最后一次写失败（磁盘满）
+    void close() {
+        FILE* f = std::exchange(f_, nullptr);
+        if (f && std::fclose(f) != 0) throw std::runtime_error("external_sort: 关闭文件出错 " + path_);
+    }
+
+private:
+    std::string path_;
+    FILE* f_;
+};
+
+// 临时顺串文件：统一起名，析构时（包括出异常时）全部删掉
+class TempFiles {
+public:
+    explicit TempFiles(const std::string& dir)
+            : dir_(dir.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(dir)),
+              prefix_("extsort_" + std::to_string(Clock::now().time_since_epoch().count()) + "_" +
+                      std::to_string(reinterpret_cast<uintptr_t>(this)) + "_") {}
+    ~TempFiles() {
+        for (auto& p : paths_) remove(p);
+    }
+    TempFiles(const TempFiles&) = delete;
+    TempFiles& operator=(const TempFiles&) = delete;
+
+    std::string make() {
+        paths_.push_back((dir_ / (prefix_ + std::to_string(paths_.size()) + ".run")).string());
+        return paths_.back();
+    }
+
+    static void remove(const std::string& path) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+private:
+    std::filesystem::path dir_;
+    std::string prefix_;
+    std::vector<std::string> paths_;
+};
+
+// 出异常时先等飞行中的 I/O 落地，再释放它读写的缓冲
+template<typename T>
+void settle(Future<T>& f) noexcept {
+    if (!f.valid()) return;
+    try {
+        f.get();
+    } catch (...) {
+    }
+}
+
+struct Run {
+    std::string path;
+    uint64_t count;
+};
+
+// 一路顺串的双缓冲读者：消费一块的同时，I/O 池在读下一块
+template<typename T>
+class RunReader {
+public:
+    RunReader(ThreadPool& io, const Run& run, T* buf0, T* buf1, size_t block)
+            : io_(io), file_(run.path, "rb"), remaining_(run.count), buf_{buf0, buf1}, block_(block) {
+        request();
+    }
+
+    // 换到下一块；顺串读完返回 false
+    bool next(const T*& pos, const T*& end) {
+        if (!pending_.valid()) return false;
+        size_t n = pending_.get();
+        pos = buf_[back_];
+        end = pos + n;
+        back_ ^= 1;
+        request(); // 上一块已经消费完，可以拿来装再下一块
+        return true;
+    }
+
+    void settle() noexcept { external_detail::settle(pending_); }
+
+private:
+    void request() {
+        if (remaining_ == 0) return;
+        size_t n = static_cast<size_t>(std::min<uint64_t>(block_, remaining_));
+        remaining_ -= n;
+        T* dst = buf_[back_];
+        pending_ = async_on(io_, [this, dst, n]() {
+            if (file_.read(dst, n * sizeof(T)) != n * sizeof(T)) throw std::runtime_error("external_sort: 顺串文件被截断");
+            return n;
+        });
+    }
+
+    ThreadPool& io_;
+    File file_;
+    uint64_t remaining_; // 还没发出读请求的元素数
+    T* buf_[2];
+    size_t block_;
+    int back_ = 0;
+    Future<size_t> pending_;
+};
+
+// 双缓冲写者：攒满一块交给 I/O 池写，接着往另一块里攒
+template<typename T>
+class RunWriter {
+public:
+    RunWriter(ThreadPool& io, const std::string& path, T* buf0, T* buf1, size_t block)
+            : io_(io), file_(path, "wb"), buf_{buf0, buf1}, block_(block) {}
+
+    void push(const T& x) {
+        buf_[cur_][fill_++] = x;
+        if (fill_ == block_) flush();
+    }
+
+    void finish() {
+        flush();
+        if (pending_.valid()) pending_.get();
+        file_.close();
+    }
+
+    void settle() noexcept { external_detail::settle(pending_); }
+
+private:
+    void flush() {
+        if (fill_ == 0) return;
+        if (pending_.valid()) pending_.get(); // 另一块还在写：等它写完才能复用
+        const T* src = buf_[cur_];
+        size_t n = fill_;
+        pending_ = async_on(io_, [this, src, n]() { file_.write(src, n * sizeof(T)); });
+        cur_ ^= 1;
+        fill_ = 0;
+    }
+
+    ThreadPool& io_;
+    File file_;
+    T* buf_[2];
+    size_t block_;
+    int cur_ = 0;
+    size_t fill_ = 0;
+    Future<void> pending_;
+};
+
+template<typename T, typename Compare>
+class ExternalSorter {
+public:
+    ExternalSorter(WorkStealingPool& pool, const ExternalSortOptions& options, Compare& comp)
+            : pool_(pool), options_(options), comp_(comp), temps_(options.temp_dir), io_(2) {}
+
+    ExternalSortStats sort(const std::string& input_path, const std::string& output_path) {
+        uint64_t bytes = std::filesystem::file_size(input_path);
+        if (bytes % sizeof(T) != 0) throw std::runtime_error("external_sort: 文件大小不是元素大小的整数倍 " + input_path);
+        stats_.elements = bytes / sizeof(T);
+
+        auto start = Clock::now();
+        std::vector<Run> runs = form_runs(input_path);
+        stats_.runs = runs.size();
+        stats_.run_seconds = seconds_since(start);
+
+        start = Clock::now();
+        if (runs.empty()) {
+            File(output_path, "wb").close();
+        } else if (runs.size() == 1) {
+            publish(runs[0].path, output_path);
+        } else {
+            // 一趟最多几路：每路两块读缓冲 + 输出两块，块不小于 min_block_bytes
+            size_t ways = std::max<size_t>(2, options_.memory_bytes / (2 * std::max<size_t>(options_.min_block_bytes, 1)));
+            ways = std::max<size_t>(2, ways - 1);
+            while (runs.size() > ways) {
+                // 分成 ceil(runs/ways) 组，组大小尽量均匀
+                size_t groups = (runs.size() + ways - 1) / ways;
+                std::vector<Run> next;
+                for (size_t g = 0; g < groups; ++g) {
+                    std::vector<Run> group(runs.begin() + static_cast<std::ptrdiff_t>(runs.size() * g / groups),
+                                           runs.begin() + static_cast<std::ptrdiff_t>(runs.size() * (g + 1) / groups));
+                    if (group.size() == 1) {
+                        next.push_back(group[0]);
+                        continue;
+                    }
+                    Run merged{temps_.make(), 0};
+                    for (auto& r : group) merged.count += r.count;
+                    merge(group, merged.path);
+                    next.push_back(merged);
+                }
+                runs.swap(next);
+                ++stats_.merge_passes;
+            }
+            merge(runs, output_path);
+            ++stats_.merge_passes;
+        }
+        stats_.merge_seconds = seconds_since(start);
+        return stats_;
+    }
+
+private:
+    // 第一阶段：三块缓冲轮转 + 一块排序用的 scratch
+    // 第 i 轮：等 read(i) → 发出 read(i+1) → 排第 i 块 → 等 write(i-1) → 发出 write(i)
+    // read(i+1) 用的缓冲上一次是 write(i-2) 在用，它在第 i-1 轮里就等过了
+    std::vector<Run> form_runs(const std::string& input_path) {
+        size_t chunk = std::max<size_t>(1, options_.memory_bytes / (4 * sizeof(T)));
+        std::unique_ptr<T[]> arena(new T[chunk * 4]);
+        T* buf[3] = {arena.get(), arena.get() + chunk, arena.get() + 2 * chunk};
+        T* scratch = arena.get() + 3 * chunk;
+
+        File input(input_path, "rb");
+        std::vector<Run> runs;
+        auto read_into = [&](T* dst) {
+            return async_on(io_, [&input, dst, chunk]() {
+                size_t got = input.read(dst, chunk * sizeof(T));
+                if (got % sizeof(T) != 0) throw std::runtime_error("external_sort: 输入文件被截断");
+                return got / sizeof(T);
+            });
+        };
+
+        Future<size_t> reading = read_into(buf[0]);
+        Future<void> writing;
+        try {
+            for (size_t i = 0;; ++i) {
+                size_t got = reading.get();
+                if (got == 0) break;
+                T* cur = buf[i % 3];
+                reading = got == chunk ? read_into(buf[(i + 1) % 3]) : make_ready_future<size_t>(0);
+
+                parallel_merge_sort_buffered(pool_, cur, cur + got, scratch, comp_);
+
+                if (writing.valid()) writing.get();
+                runs.push_back(Run{temps_.make(), got});
+                writing = async_on(io_, [cur, got, path = runs.back().path]() {
+                    File out(path, "wb");
+                    out.write(cur, got * sizeof(T));
+                    out.close();
+                });
+            }
+            if (writing.valid()) writing.get();
+        } catch (...) {
+            settle(reading);
+            settle(writing);
+            throw;
+        }
+        return runs;
+    }
+
+    // k 路归并：败者树 tree[1..k-1] 存每场比赛的败者，tree[0] 是总冠军
+    // 叶子 i 挂在 i + k 的位置，弹出冠军后只沿它到根的那一条路重赛，每个元素 log k 次比较
+    void merge(const std::vector<Run>& runs, const std::string& out_path) {
+        size_t k = runs.size();
+        size_t block = std::max<size_t>(1, options_.memory_bytes / (sizeof(T) * 2 * (k + 1)));
+        std::unique_ptr<T[]> arena(new T[block * 2 * (k + 1)]);
+
+        std::vector<std::unique_ptr<RunReader<T>>> readers;
+        std::unique_ptr<RunWriter<T>> writer;
+        try {
+            readers.reserve(k);
+            for (size_t i = 0; i < k; ++i) {
+                readers.push_back(std::make_unique<RunReader<T>>(io_, runs[i], arena.get() + 2 * i * block,
+                                                                 arena.get() + (2 * i + 1) * block, block));
+            }
+            writer = std::make_unique<RunWriter<T>>(io_, out_path, arena.get() + 2 * k * block,
+                                                    arena.get() + (2 * k + 1) * block, block);
+
+            // 每路当前块的 [head, tail)；读完的路 head 为空，当作 +∞
+            std::vector<const T*> head(k, nullptr), tail(k, nullptr);
+            for (size_t i = 0; i < k; ++i) {
+                if (!readers[i]->next(head[i], tail[i])) head[i] = nullptr;
+            }
+            auto beats = [&](size_t a, size_t b) {
+                if (!head[a]) return false;
+                if (!head[b]) return true;
+                return comp_(*head[a], *head[b]);
+            };
+
+            std::vector<size_t> tree(k), winner(2 * k);
+            for (size_t i = 0; i < k; ++i) winner[k + i] = i;
+            for (size_t node = k - 1; node >= 1; --node) {
+                size_t a = winner[2 * node], b = winner[2 * node + 1];
+                if (beats(b, a)) std::swap(a, b);
+                winner[node] = a;
+                tree[node] = b;
+            }
+            tree[0] = winner[1];
+
+            while (true) {
+                size_t w = tree[0];
+                if (!head[w]) break; // 冠军都是 +∞：全部读完
+                writer->push(*head[w]);
+                if (++head[w] == tail[w] && !readers[w]->next(head[w], tail[w])) head[w] = nullptr;
+                for (size_t node = (w + k) / 2; node > 0; node /= 2) {
+                    if (beats(tree[node], w)) std::swap(tree[node], w);
+                }
+                tree[0] = w;
+            }
+            writer->finish();
+        } catch (...) {
+            for (auto& r : readers) r->settle();
+            if (writer) writer->settle();
+            throw;
+        }
+        readers.clear(); // 先关文件再删
+        for (auto& r : runs) TempFiles::remove(r.path);
+    }
+
+    // 只有一个顺串：它就是结果，改个名即可（跨文件系统改名失败就拷过去）
+    static void publish(const std::string& from, const std::string& to) {
+        std::error_code ec;
+        std::filesystem::rename(from, to, ec);
+        if (ec) std::filesystem::copy_file(from, to, std::filesystem::copy_options::overwrite_existing);
+    }
+
+    WorkStealingPool& pool_;
+    ExternalSortOptions options_;
+    Compare& comp_;
+    ExternalSortStats stats_;
+    TempFiles temps_;
+    ThreadPool io_; // 最后构造、最先析构：它的线程退出之后，上面的东西才释放
+};
+
+} // namespace external_detail
+
+// =========================
+// external_sort<T>(pool, input_path, output_path, options, comp)
+// 把 input_path 里的 T 数组（原始字节）排好写到 output_path，两者可以是同一个文件
+// 内存占用不超过 options.memory_bytes（外加几个小的索引数组）；临时文件放 options.temp_dir，结束（包括出错）时删掉
+// 打不开文件、读写失败、文件大小不是 sizeof(T) 的整数倍都抛 std::runtime_error
+// =========================
+template<typename T, typename Compare = std::less<>>
+ExternalSortStats external_sort(WorkStealingPool& pool, const std::string& input_path, const std::string& output_path,
+                                const ExternalSortOptions& options = ExternalSortOptions(), Compare comp = Compare()) {
+    static_assert(std::is_trivially_copyable_v<T>, "external_sort 按原始字节读写，T 必须可平凡复制");
+    external_detail::ExternalSorter<T, Compare> sorter(pool, options, comp);
+    return sorter.sort(input_path, output_path);
+}
+
+// 用默认工作窃取池
+template<typename T, typename Compare = std::less<>>
+ExternalSortStats external_sort(const std::string& input_path, const std::string& output_path,
+                                const ExternalSortOptions& options = ExternalSortOptions(), Compare comp = Compare()) {
+    return external_sort<T>(default_work_stealing_pool(), input_path, output_path, options, comp);
+}
+
+#endif //CONCURRENCY_STUDY_EXTERNALSORT_H
@@ -0,0 +1,140 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <filesystem>
+#include "ExternalSort.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// 写一个 n 个随机 uint64 的文件，返回所有元素之和（校验用，溢出回绕无所谓）
+uint64_t make_input(const std::string& path, uint64_t n) {
+    std::mt19937_64 gen(42);
+    std::vector<uint64_t> buf(1 << 20);
+    uint64_t sum = 0;
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    for (uint64_t done = 0; done < n;) {
+        size_t m = static_cast<size_t>(std::min<uint64_t>(buf.size(), n - done));
+        for (size_t i = 0; i < m; ++i) {
+            buf[i] = gen();
+            sum += buf[i];
+        }
+        std::fwrite(buf.data(), sizeof(uint64_t), m, f);
+        done += m;
+    }
+    std::fclose(f);
+    return sum;
+}
+
+// 流式检查输出：个数、和、有序
+bool check_output(const std::string& path, uint64_t n, uint64_t sum) {
+    std::vector<uint64_t> buf(1 << 20);
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    uint64_t count = 0, total = 0, prev = 0;
+    bool sorted = true;
+    size_t m;
+    while ((m = std::fread(buf.data(), sizeof(uint64_t), buf.size(), f)) > 0) {
+        for (size_t i = 0; i < m; ++i) {
+            sorted = sorted && prev <= buf[i];
+            prev = buf[i];
+            total += buf[i];
+        }
+        count += m;
+    }
+    std::fclose(f);
+    return sorted && count == n && total == sum;
+}
+
+// 对照：同样大小的文件顺序读一遍、写一遍要多久（外部排序至少读写两遍：生成顺串一遍，归并一遍）
+double copy_seconds(const std::string& from, const std::string& to) {
+    std::vector<char> buf(8 << 20);
+    auto start = Clock::now();
+    std::FILE* in = std::fopen(from.c_str(), "rb");
+    std::FILE* out = std::fopen(to.c_str(), "wb");
+    size_t m;
+    while ((m = std::fread(buf.data(), 1, buf.size(), in)) > 0) std::fwrite(buf.data(), 1, m, out);
+    std::fclose(in);
+    std::fclose(out);
+    return seconds_since(start);
+}
+
+void report(const std::string& name, const ExternalSortStats& s, double total, double copy, bool ok) {
+    double mb = static_cast<double>(s.elements * sizeof(uint64_t)) / (1 << 20);
+    std::cout << name << ": " << s.runs << " 个顺串，" << s.merge_passes << " 趟归并；生成顺串 " << s.run_seconds
+              << " s，归并 " << s.merge_seconds << " s，合计 " << total << " s (" << mb / total << " MB/s)；"
+              << "同样的文件读写一遍 " << copy << " s，相当于 " << total / copy << " 遍"
+              << (ok ? "" : " 结果不对!") << std::endl;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    std::cout << std::fixed << std::setprecision(2);
+    auto dir = std::filesystem::temp_directory_path();
+    std::string input = (dir / "extsort_input.bin").string();
+    std::string output = (dir / "extsort_output.bin").string();
+    std::string copy = (dir / "extsort_copy.bin").string();
+
+    const uint64_t N = 20000000; // 160 MB
+    uint64_t sum = make_input(input, N);
+    double copy_s = copy_seconds(input, copy);
+    std::cout << "输入 " << N << " 个 uint64，工人数 " << default_work_stealing_pool().thread_count() << std::endl;
+
+    // 1. 64 MB 内存上限：10 个顺串，一趟归并
+    {
+        ExternalSortOptions opt;
+        opt.memory_bytes = size_t(64) << 20;
+        auto start = Clock::now();
+        ExternalSortStats s = external_sort<uint64_t>(input, output, opt);
+        double total = seconds_since(start);
+        report("内存 64 MB", s, total, copy_s, check_output(output, N, sum));
+    }
+
+    // 2. 4 MB 上限、每路至少 256 KB：一趟最多 7 路，160 个顺串要先分组归并几趟
+    {
+        ExternalSortOptions opt;
+        opt.memory_bytes = size_t(4) << 20;
+        opt.min_block_bytes = size_t(256) << 10;
+        auto start = Clock::now();
+        ExternalSortStats s = external_sort<uint64_t>(input, output, opt);
+        double total = seconds_since(start);
+        report("内存 4 MB ", s, total, copy_s, check_output(output, N, sum));
+    }
+
+    // 3. 出错：文件大小不是元素大小的整数倍
+    {
+        std::FILE* f = std::fopen(copy.c_str(), "ab");
+        std::fputc(0, f);
+        std::fclose(f);
+        try {
+            external_sort<uint64_t>(copy, output);
+        } catch (const std::exception& e) {
+            std::cout << "捕获异常: " << e.what() << std::endl;
+        }
+    }
+
+    std::filesystem::remove(input);
+    std::filesystem::remove(output);
+    std::filesystem::remove(copy);
+    return 0;
+}
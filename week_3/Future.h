@@ -0,0 +1,788 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_FUTURE_H
+#define CONCURRENCY_STUDY_FUTURE_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <future>
+#include <optional>
+#include <vector>
+#include <utility>
+#include <type_traits>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+
+#include "ThreadPool.h"
+
+// =========================
+// 可组合的 Future / Promise
+// std::future 只能 get() 干等，每个“汇合点”都要占一个线程；这里结果出来时直接触发续体：
+//   async_on(pool, f).then(pool, g).then(h)
+//   when_all(futures).then(...)  /  when_any(futures).then(...)
+// 整条链从头到尾没有线程在等，只有 main 最后 get() 一下
+//
+// 开销：每一步（then / async_on）只有一次分配 —— 续体本身就是下一步的共享状态，
+// 函数对象直接存在里面；引用计数是侵入式的，共享状态从按大小分级的线程本地块池里拿，
+// 跨线程释放的块会还给分配它的线程，稳态下连这一次 operator new 也省掉了
+// =========================
+
+template<typename T> class Future;
+template<typename T> class Promise;
+
+namespace future_detail {
+
+// ---------- 块池：按 64 字节分级，每个线程一份空闲链表 ----------
+// 每块前面有个块头记着它是哪个线程分出去的。别的线程释放时不进自己的链表，
+// 而是压回原主人的无锁归还栈，主人下次本地链表空了再整串收回来 ——
+// 在提交线程上分配、在工人线程上释放的状态（async_on(pool, ...).then(pool, ...)）也能回到原处重用
+class BlockPool {
+public:
+    static constexpr size_t kGranule = 64;
+    static constexpr size_t kClasses = 8;      // 连块头最大 512 字节，再大直接走 operator new
+    static constexpr size_t kMaxCached = 256;  // 每级最多缓存这么多块
+
+    static void* allocate(size_t n) {
+        size_t c = class_of(n + sizeof(Header));
+        if (c >= kClasses) return ::operator new(n);
+        Home* h = home();
+        if (h != nullptr) {
+            if (!h->heads[c]) h->collect();
+            if (Header* block = h->heads[c]) {
+                h->heads[c] = next_of(block);
+                --h->counts[c];
+                return block + 1;
+            }
+        }
+        auto* block = static_cast<Header*>(::operator new((c + 1) * kGranule));
+        block->owner = h;
+        block->cls = c;
+        if (h != nullptr) h->refs.fetch_add(1, std::memory_order_relaxed);
+        return block + 1;
+    }
+
+    static void deallocate(void* p, size_t n) {
+        size_t c = class_of(n + sizeof(Header));
+        if (c >= kClasses) {
+            ::operator delete(p);
+            return;
+        }
+        Header* block = static_cast<Header*>(p) - 1;
+        Home* owner = block->owner;
+        if (owner == nullptr) { // 线程退出之后分出去的，没有主人
+            ::operator delete(block);
+            return;
+        }
+        if (owner == raw().home) owner->put(block);
+        else owner->give_back(block);
+    }
+
+private:
+    struct Home;
+
+    // 空闲时 next 放在块头后面的负载里
+    struct alignas(alignof(std::max_align_t)) Header {
+        Home* owner;
+        size_t cls;
+    };
+
+    static Header*& next_of(Header* block) { return *reinterpret_cast<Header**>(block + 1); }
+
+    // 主人线程退出后归还栈被换成这个哨兵，之后还回来的块直接释放
+    static Header* closed() {
+        static Header sentinel{};
+        return &sentinel;
+    }
+
+    // 块真正还给 operator delete；主人的引用计数 = 线程本身 + 还活着的块
+    static void release(Header* block) noexcept {
+        Home* owner = block->owner;
+        ::operator delete(block);
+        if (owner->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete owner;
+    }
+
+    // 堆上分配：线程退出后，别的线程手里还有它的块，归还栈得一直活到最后一块回来
+    struct Home {
+        Header* heads[kClasses] = {};
+        size_t counts[kClasses] = {};
+        std::atomic<Header*> returned{nullptr};
+        std::atomic<size_t> refs{1};
+
+        // 只在主人线程上调用
+        void put(Header* block) noexcept {
+            size_t c = block->cls;
+            if (counts[c] >= kMaxCached) {
+                release(block);
+                return;
+            }
+            next_of(block) = heads[c];
+            heads[c] = block;
+            ++counts[c];
+        }
+
+        void collect() noexcept {
+            if (returned.load(std::memory_order_relaxed) == nullptr) return;
+            Header* list = returned.exchange(nullptr, std::memory_order_acquire);
+            while (list) {
+                Header* next = next_of(list);
+                put(list);
+                list = next;
+            }
+        }
+
+        // 任意线程：压进归还栈；主人已经退出就直接释放
+        void give_back(Header* block) noexcept {
+            Header* head = returned.load(std::memory_order_relaxed);
+            do {
+                if (head == closed()) {
+                    release(block);
+                    return;
+                }
+                next_of(block) = head;
+            } while (!returned.compare_exchange_weak(head, block, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+        }
+    };
+
+    // 平凡可析构：线程退出时（Cleaner 已经跑过）还能安全地看 dead 标记
+    struct Local {
+        Home* home;
+        bool dead;
+    };
+
+    struct Cleaner {
+        ~Cleaner() {
+            Local& l = raw();
+            Home* h = l.home;
+            l.home = nullptr;
+            l.dead = true;
+            for (size_t c = 0; c < kClasses; ++c) {
+                while (h->heads[c]) {
+                    Header* next = next_of(h->heads[c]);
+                    release(h->heads[c]);
+                    h->heads[c] = next;
+                }
+            }
+            Header* list = h->returned.exchange(closed(), std::memory_order_acquire);
+            while (list) {
+                Header* next = next_of(list);
+                release(list);
+                list = next;
+            }
+            if (h->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete h;
+        }
+    };
+
+    static size_t class_of(size_t n) { return (n + kGranule - 1) / kGranule - 1; }
+
+    static Local& raw() {
+        thread_local Local local{};
+        return local;
+    }
+
+    // 第一次用到时才建 Home、登记 Cleaner；Cleaner 析构之后不会再经过它的定义
+    static Home* home() {
+        Local& l = raw();
+        if (l.home == nullptr && !l.dead) {
+            l.home = new Home;
+            thread_local Cleaner cleaner;
+            (void)cleaner;
+        }
+        return l.home;
+    }
+};
+
+// 用块池创建一个对象；对象的 destroy() 里用 pooled_delete 释放
+template<typename D, typename... Args>
+D* pooled_new(Args&&... args) {
+    void* p = BlockPool::allocate(sizeof(D));
+    try {
+        return new (p) D(std::forward<Args>(args)...);
+    } catch (...) {
+        BlockPool::deallocate(p, sizeof(D));
+        throw;
+    }
+}
+
+template<typename D>
+void pooled_delete(D* d) noexcept {
+    d->~D();
+    BlockPool::deallocate(d, sizeof(D));
+}
+
+struct Unit {}; // void 结果的占位
+
+template<typename T>
+using stored_t = std::conditional_t<std::is_void_v<T>, Unit, T>;
+
+template<typename T>
+struct is_future : std::false_type {};
+template<typename T>
+struct is_future<Future<T>> : std::true_type {};
+
+// 结果就绪时被调用一次
+struct Callback {
+    virtual void fire() noexcept = 0;
+protected:
+    ~Callback() = default;
+};
+
+// 侵入式引用计数
+class StateBase {
+public:
+    void add_ref() noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) destroy();
+    }
+
+protected:
+    virtual ~StateBase() = default;
+    virtual void destroy() noexcept = 0;
+
+private:
+    std::atomic<uint32_t> refs_{1};
+};
+
+struct ReadyTag final : Callback {
+    void fire() noexcept override {}
+};
+inline ReadyTag ready_tag_instance;
+
+// 共享状态：结果 + 一个续体槽
+// 续体槽：nullptr = 还没结果也没人等；ready_tag = 已经有结果；其他 = 等着的续体
+// 先设结果再 exchange(ready_tag)；挂续体用 CAS(nullptr -> cb)，失败说明已经就绪，当场触发
+template<typename T>
+class State : public StateBase {
+public:
+    using Stored = stored_t<T>;
+
+    template<typename... A>
+    void set_value(A&&... a) {
+        value_.emplace(std::forward<A>(a)...);
+        complete();
+    }
+
+    void set_exception(std::exception_ptr e) {
+        error_ = std::move(e);
+        complete();
+    }
+
+    bool ready() const { return slot_.load(std::memory_order_acquire) == ready_tag(); }
+
+    void attach(Callback* cb) {
+        Callback* expected = nullptr;
+        if (!slot_.compare_exchange_strong(expected, cb, std::memory_order_acq_rel)) cb->fire();
+    }
+
+    // 下面几个只在就绪之后调用
+    bool has_error() const { return static_cast<bool>(error_); }
+    const std::exception_ptr& error() const { return error_; }
+    Stored& value() { return *value_; }
+
+    Stored take() {
+        if (error_) std::rethrow_exception(error_);
+        return std::move(*value_);
+    }
+
+private:
+    static Callback* ready_tag() { return &ready_tag_instance; }
+
+    void complete() {
+        Callback* cb = slot_.exchange(ready_tag(), std::memory_order_acq_rel);
+        if (cb) cb->fire();
+    }
+
+    std::optional<Stored> value_;
+    std::exception_ptr error_;
+    std::atomic<Callback*> slot_{nullptr};
+};
+
+// Promise / make_ready_future 用的普通状态
+template<typename T>
+class PlainState final : public State<T> {
+protected:
+    void destroy() noexcept override { pooled_delete(this); }
+};
+
+// 把 fn 交给线程池。延续丢了就有人永远等下去，所以走 enqueue_must_run：
+// 不看溢出策略（不会被 Reject / DropOldest 丢掉），也从不阻塞；池子停了就原地执行
+template<typename Fn>
+void post(ThreadPool* pool, Fn&& fn) {
+    if (pool == nullptr || !pool->enqueue_must_run(fn)) fn();
+}
+
+// 用 src 的结果（值或异常）完成 dst
+template<typename T>
+void forward_result(State<T>& src, State<T>& dst) {
+    if (src.has_error()) dst.set_exception(src.error());
+    else dst.set_value(std::move(src.value()));
+}
+
+// then 的续体：既是上一步的 Callback，又是下一步（Future<Out>）的共享状态
+template<typename In, typename Out, typename F>
+class ThenState final : public State<Out>, private Callback {
+public:
+    ThenState(State<In>* parent, F f, ThreadPool* pool)
+            : parent_(parent), f_(std::move(f)), pool_(pool), inner_(this) {
+        this->add_ref(); // 续体还没跑完之前，自己不能没了
+        parent_->attach(static_cast<Callback*>(this));
+    }
+
+    // f 返回 Future<Out> 时，等那个内层 future
+    struct Inner final : Callback {
+        explicit Inner(ThenState* o) : owner(o) {}
+        void fire() noexcept override {
+            forward_result(*owner->inner_state_, *owner);
+            owner->inner_state_->release();
+            owner->release();
+        }
+        ThenState* owner;
+    };
+
+private:
+    void fire() noexcept override {
+        post(pool_, [this]() { run(); });
+    }
+
+    void run() noexcept {
+        if (parent_->has_error() && !takes_future()) {
+            this->set_exception(parent_->error());
+        } else {
+            try {
+                invoke();
+            } catch (...) {
+                this->set_exception(std::current_exception());
+            }
+        }
+        parent_->release();
+        parent_ = nullptr;
+        // 等内层 future 时由 Inner 释放；attach 可能当场触发，所以这是最后一步
+        if (inner_state_ != nullptr) inner_state_->attach(&inner_);
+        else this->release();
+    }
+
+    static constexpr bool takes_future() { return std::is_invocable_v<F&, Future<In>&&>; }
+
+    void invoke() {
+        if constexpr (takes_future()) {
+            parent_->add_ref();
+            deliver([this]() { return f_(Future<In>(parent_)); });
+        } else if constexpr (std::is_void_v<In>) {
+            deliver([this]() { return f_(); });
+        } else {
+            deliver([this]() { return f_(std::move(parent_->value())); });
+        }
+    }
+
+    template<typename Call>
+    void deliver(Call&& call) {
+        using R = decltype(call());
+        if constexpr (is_future<R>::value) {
+            R inner = call();
+            if (!inner.valid()) throw std::future_error(std::future_errc::no_state);
+            inner_state_ = inner.detach(); // 挂续体放到 run() 最后
+        } else if constexpr (std::is_void_v<R>) {
+            call();
+            this->set_value();
+        } else {
+            this->set_value(call());
+        }
+    }
+
+    void destroy() noexcept override { pooled_delete(this); }
+
+    State<In>* parent_;
+    F f_;
+    ThreadPool* pool_;
+    Inner inner_;
+    State<Out>* inner_state_ = nullptr;
+};
+
+// async_on 的状态：函数对象存在状态里，投给线程池的任务只捕获一个指针
+template<typename R, typename F>
+class AsyncState final : public State<R> {
+public:
+    AsyncState(F f) : f_(std::move(f)) {}
+
+    void run() noexcept {
+        try {
+            if constexpr (std::is_void_v<R>) {
+                f_();
+                this->set_value();
+            } else {
+                this->set_value(f_());
+            }
+        } catch (...) {
+            this->set_exception(std::current_exception());
+        }
+        this->release(); // 任务持有的那一份
+    }
+
+private:
+    void destroy() noexcept override { pooled_delete(this); }
+    F f_;
+};
+
+// get() 阻塞等待用：挂在栈上的续体
+struct BlockingWaiter final : Callback {
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool done = false;
+
+    void fire() noexcept override {
+        std::lock_guard<std::mutex> lock(mtx); // 持锁通知：等待方一返回这个对象就没了
+        done = true;
+        cv.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return done; });
+    }
+};
+
+template<typename T> class WhenAllState;
+template<typename T> class WhenAnyState;
+
+} // namespace future_detail
+
+// =========================
+// Future<T>：只能移动；结果只能被消费一次（get 或 then）
+// =========================
+template<typename T>
+class Future {
+public:
+    Future() = default;
+    explicit Future(future_detail::State<T>* s) noexcept : state_(s) {}
+    Future(Future&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+    Future& operator=(Future&& other) noexcept {
+        if (this != &other) {
+            reset();
+            state_ = std::exchange(other.state_, nullptr);
+        }
+        return *this;
+    }
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+    ~Future() { reset(); }
+
+    bool valid() const { return state_ != nullptr; }
+    bool is_ready() const { return state_ && state_->ready(); }
+
+    // 阻塞拿结果（或重新抛出异常）：只给 main 这种“最外层”用，链条内部用 then
+    T get() {
+        if (!state_) throw std::future_error(std::future_errc::no_state);
+        if (!state_->ready()) {
+            future_detail::BlockingWaiter waiter;
+            state_->attach(&waiter);
+            waiter.wait();
+        }
+        future_detail::State<T>* s = std::exchange(state_, nullptr);
+        struct Releaser {
+            future_detail::State<T>* s;
+            ~Releaser() { s->release(); }
+        } guard{s};
+        if constexpr (std::is_void_v<T>) {
+            s->take();
+        } else {
+            return s->take();
+        }
+    }
+
+    // 续体：结果就绪后在 pool 里执行 f（pool 为空指针时在完成结果的那个线程上直接执行）
+    //   f(T)：上一步抛了异常就跳过 f，异常继续往后传
+    //   f(Future<T>)：无论成败都调用，可以自己 get() 处理异常
+    //   f 返回 Future<V> 时自动展开，得到 Future<V> 而不是 Future<Future<V>>
+    template<typename F>
+    auto then(ThreadPool& pool, F f) { return then_impl(&pool, std::move(f)); }
+
+    template<typename F>
+    auto then(F f) { return then_impl(nullptr, std::move(f)); }
+
+private:
+    template<typename> friend class Future;
+    template<typename, typename, typename> friend class future_detail::ThenState;
+    template<typename> friend class future_detail::WhenAllState;
+    template<typename> friend class future_detail::WhenAnyState;
+
+    template<typename F>
+    static auto result_of() {
+        if constexpr (std::is_invocable_v<F&, Future<T>&&>) {
+            return std::invoke_result<F&, Future<T>&&>{};
+        } else if constexpr (std::is_void_v<T>) {
+            return std::invoke_result<F&>{};
+        } else {
+            return std::invoke_result<F&, T&&>{};
+        }
+    }
+
+    template<typename R>
+    struct unwrap { using type = R; };
+    template<typename V>
+    struct unwrap<Future<V>> { using type = V; };
+
+    template<typename F>
+    auto then_impl(ThreadPool* pool, F f) {
+        using R = typename decltype(result_of<F>())::type;
+        using Out = typename unwrap<R>::type;
+        if (!state_) throw std::future_error(std::future_errc::no_state);
+        auto* next = future_detail::pooled_new<future_detail::ThenState<T, Out, F>>(
+                std::exchange(state_, nullptr), std::move(f), pool);
+        return Future<Out>(next);
+    }
+
+    // 交出共享状态（引用计数跟着走）
+    future_detail::State<T>* detach() noexcept { return std::exchange(state_, nullptr); }
+
+    void reset() noexcept {
+        if (state_) state_->release();
+        state_ = nullptr;
+    }
+
+    future_detail::State<T>* state_ = nullptr;
+};
+
+// =========================
+// Promise<T>：生产方。没兑现就析构，等它的人会收到 broken_promise
+// =========================
+template<typename T>
+class Promise {
+public:
+    Promise() : state_(future_detail::pooled_new<future_detail::PlainState<T>>()) {}
+    Promise(Promise&& other) noexcept
+            : state_(std::exchange(other.state_, nullptr)), retrieved_(other.retrieved_), satisfied_(other.satisfied_) {}
+    Promise& operator=(Promise&& other) noexcept {
+        if (this != &other) {
+            abandon();
+            state_ = std::exchange(other.state_, nullptr);
+            retrieved_ = other.retrieved_;
+            satisfied_ = other.satisfied_;
+        }
+        return *this;
+    }
+    Promise(const Promise&) = delete;
+    Promise& operator=(const Promise&) = delete;
+    ~Promise() { abandon(); }
+
+    Future<T> get_future() {
+        if (!state_ || retrieved_) throw std::future_error(std::future_errc::future_already_retrieved);
+        retrieved_ = true;
+        state_->add_ref();
+        return Future<T>(state_);
+    }
+
+    template<typename... A>
+    void set_value(A&&... a) {
+        check();
+        state_->set_value(std::forward<A>(a)...);
+    }
+
+    void set_exception(std::exception_ptr e) {
+        check();
+        state_->set_exception(std::move(e));
+    }
+
+private:
+    void check() {
+        if (!state_) throw std::future_error(std::future_errc::no_state);
+        if (satisfied_) throw std::future_error(std::future_errc::promise_already_satisfied);
+        satisfied_ = true;
+    }
+
+    void abandon() noexcept {
+        if (!state_) return;
+        if (!satisfied_) {
+            state_->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+        state_->release();
+        state_ = nullptr;
+    }
+
+    future_detail::PlainState<T>* state_ = nullptr;
+    bool retrieved_ = false;
+    bool satisfied_ = false;
+};
+
+template<typename T>
+Future<std::decay_t<T>> make_ready_future(T&& value) {
+    auto* s = future_detail::pooled_new<future_detail::PlainState<std::decay_t<T>>>();
+    s->set_value(std::forward<T>(value));
+    return Future<std::decay_t<T>>(s);
+}
+
+inline Future<void> make_ready_future() {
+    auto* s = future_detail::pooled_new<future_detail::PlainState<void>>();
+    s->set_value();
+    return Future<void>(s);
+}
+
+template<typename T>
+Future<T> make_exceptional_future(std::exception_ptr e) {
+    auto* s = future_detail::pooled_new<future_detail::PlainState<T>>();
+    s->set_exception(std::move(e));
+    return Future<T>(s);
+}
+
+// 在线程池里执行 f，返回它的 Future
+template<typename F>
+Future<std::invoke_result_t<F&>> async_on(ThreadPool& pool, F f) {
+    using R = std::invoke_result_t<F&>;
+    auto* s = future_detail::pooled_new<future_detail::AsyncState<R, F>>(std::move(f));
+    s->add_ref(); // 投出去的任务持有一份
+    future_detail::post(&pool, [s]() { s->run(); });
+    return Future<R>(s);
+}
+
+namespace future_detail {
+
+// when_all：每个输入挂一个子续体，计数减到 0 时收集结果
+template<typename T>
+class WhenAllState final : public State<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>> {
+public:
+    explicit WhenAllState(std::vector<Future<T>>& inputs)
+            : remaining_(inputs.size()) {
+        children_.reserve(inputs.size());
+        for (auto& f : inputs) children_.push_back(Child{this, f.detach()});
+    }
+
+    ~WhenAllState() override {
+        for (auto& c : children_) c.input->release();
+    }
+
+    void start() {
+        this->add_ref(); // 子续体们共同持有一份，最后一个触发的释放
+        for (auto& c : children_) c.input->attach(&c);
+    }
+
+private:
+    struct Child final : Callback {
+        Child(WhenAllState* o, State<T>* in) : owner(o), input(in) {}
+        void fire() noexcept override { owner->one_done(); }
+        WhenAllState* owner;
+        State<T>* input;
+    };
+
+    void one_done() noexcept {
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        // 全部就绪：有异常就传第一个（按输入顺序），否则按顺序收集
+        std::exception_ptr error;
+        for (auto& c : children_) {
+            if (c.input->has_error()) {
+                error = c.input->error();
+                break;
+            }
+        }
+        if (error) {
+            this->set_exception(error);
+        } else if constexpr (std::is_void_v<T>) {
+            this->set_value();
+        } else {
+            try {
+                std::vector<T> results;
+                results.reserve(children_.size());
+                for (auto& c : children_) results.push_back(std::move(c.input->value()));
+                this->set_value(std::move(results));
+            } catch (...) {
+                this->set_exception(std::current_exception());
+            }
+        }
+        this->release();
+    }
+
+    void destroy() noexcept override { pooled_delete(this); }
+
+    std::atomic<size_t> remaining_;
+    std::vector<Child> children_;
+};
+
+template<typename T>
+using when_any_result_t = std::conditional_t<std::is_void_v<T>, size_t, std::pair<size_t, T>>;
+
+// when_any：第一个完成的输入决定结果；其余输入之后完成时只释放引用
+template<typename T>
+class WhenAnyState final : public State<when_any_result_t<T>> {
+public:
+    explicit WhenAnyState(std::vector<Future<T>>& inputs) : pending_(inputs.size()) {
+        children_.reserve(inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) children_.push_back(Child{this, inputs[i].detach(), i});
+    }
+
+    ~WhenAnyState() override {
+        for (auto& c : children_) c.input->release();
+    }
+
+    void start() {
+        this->add_ref(); // 所有子续体都触发完才释放：晚到的输入还要访问 children_
+        for (auto& c : children_) c.input->attach(&c);
+    }
+
+private:
+    struct Child final : Callback {
+        Child(WhenAnyState* o, State<T>* in, size_t i) : owner(o), input(in), index(i) {}
+        void fire() noexcept override { owner->one_done(*this); }
+        WhenAnyState* owner;
+        State<T>* input;
+        size_t index;
+    };
+
+    void one_done(Child& c) noexcept {
+        if (!won_.exchange(true, std::memory_order_acq_rel)) {
+            if (c.input->has_error()) {
+                this->set_exception(c.input->error());
+            } else if constexpr (std::is_void_v<T>) {
+                this->set_value(c.index);
+            } else {
+                try {
+                    this->set_value(c.index, std::move(c.input->value()));
+                } catch (...) {
+                    this->set_exception(std::current_exception());
+                }
+            }
+        }
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) this->release();
+    }
+
+    void destroy() noexcept override { pooled_delete(this); }
+
+    std::atomic<bool> won_{false};
+    std::atomic<size_t> pending_;
+    std::vector<Child> children_;
+};
+
+} // namespace future_detail
+
+// 全部完成：Future<vector<T>>（T = void 时是 Future<void>）；任何一个失败就传出第一个异常
+template<typename T>
+auto when_all(std::vector<Future<T>> inputs) {
+    using R = std::conditional_t<std::is_void_v<T>, void, std::vector<T>>;
+    if (inputs.empty()) {
+        if constexpr (std::is_void_v<T>) return make_ready_future();
+        else return make_ready_future(std::vector<T>{});
+    }
+    for (auto& f : inputs) {
+        if (!f.valid()) throw std::future_error(std::future_errc::no_state);
+    }
+    auto* s = future_detail::pooled_new<future_detail::WhenAllState<T>>(inputs);
+    s->start();
+    return Future<R>(s);
+}
+
+// 任一完成：Future<pair<下标, 值>>（T = void 时是 Future<size_t>）
+template<typename T>
+Future<future_detail::when_any_result_t<T>> when_any(std::vector<Future<T>> inputs) {
+    if (inputs.empty()) throw std::invalid_argument("when_any needs at least one future");
+    for (auto& f : inputs) {
+        if (!f.valid()) throw std::future_error(std::future_errc::no_state);
+    }
+    auto* s = future_detail::pooled_new<future_detail::WhenAnyState<T>>(inputs);
+    s->start();
+    return Future<future_detail::when_any_result_t<T>>(s);
+}
+
+#endif //CONCURRENCY_STUDY_FUTURE_H
@@ -0,0 +1,169 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include "Future.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 统计全局 operator new 次数：看每一步 then 到底分配了几次
+static std::atomic<uint64_t> g_allocs{0};
+
+// 不让它们内联：GCC 内联以后会把 new 里的 malloc 和 delete 里的 free 当成“不配对的分配/释放”报警告
+[[gnu::noinline]] void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int calculate_sqrt(int x) {
+    return static_cast<int>(std::sqrt(x));
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    ThreadPoolOptions opt = ThreadPoolOptions::fixed(4);
+    opt.queue_capacity = 4096;
+    ThreadPool pool(opt);
+
+    // 1. 一万条三段的异步链 + when_all 汇合：4 个工人，没有一个线程在 get() 上干等
+    {
+        const int N = 10000;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Future<int>> chains;
+        chains.reserve(N);
+        for (int i = 0; i < N; ++i) {
+            chains.push_back(async_on(pool, [i] { return std::to_string(i); }) // “读请求”
+                .then(pool, [](std::string s) { return std::stoi(s); })        // 解析
+                .then(pool, [](int x) { return calculate_sqrt(x); }));         // 计算
+        }
+        long long sum = 0;
+        for (int v : when_all(std::move(chains)).get()) sum += v;
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+        std::cout << N << " 条链完成，结果和 = " << sum << "，耗时 " << us / 1000.0 << " ms" << std::endl;
+    }
+
+    // 2. 每一步的分配次数：先热身把块池填上，再数一条 10 万步的链
+    {
+        auto chain = [](int steps) {
+            Future<int> f = make_ready_future(0);
+            for (int i = 0; i < steps; ++i) f = f.then([](int x) { return x + 1; });
+            return f.get();
+        };
+        chain(1000);
+        uint64_t before = g_allocs.load();
+        int r = chain(100000);
+        uint64_t allocs = g_allocs.load() - before;
+        std::cout << "10 万步 then：结果 " << r << "，operator new " << allocs << " 次（平均每步 "
+                  << static_cast<double>(allocs) / 100000 << " 次）" << std::endl;
+
+        // 跨线程：状态在 main 上分配、在工人上释放，块得回到 main 的链表才能重用；
+        //         剩下的零头是线程池队列自己的节点
+        auto cross = [&pool](int n) {
+            std::vector<Future<int>> fs;
+            fs.reserve(n);
+            for (int i = 0; i < n; ++i) {
+                fs.push_back(async_on(pool, [i] { return i; }).then(pool, [](int x) { return x + 1; }));
+            }
+            long long sum = 0;
+            for (auto& f : fs) sum += f.get();
+            return sum;
+        };
+        for (int round = 0; round < 10; ++round) cross(200);
+        before = g_allocs.load();
+        long long sum = 0;
+        for (int round = 0; round < 500; ++round) sum += cross(200);
+        allocs = g_allocs.load() - before;
+        std::cout << "10 万条跨线程 async_on.then：结果和 " << sum << "，operator new " << allocs
+                  << " 次（平均每条 " << static_cast<double>(allocs) / 100000 << " 次）" << std::endl;
+    }
+
+    // 3. when_any：谁先到用谁
+    {
+        std::vector<Future<std::string>> replicas;
+        replicas.push_back(async_on(pool, [] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            return std::string("慢副本");
+        }));
+        replicas.push_back(async_on(pool, [] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            return std::string("快副本");
+        }));
+        auto first = when_any(std::move(replicas)).get();
+        std::cout << "when_any: 第 " << first.first << " 个先返回 (" << first.second << ")" << std::endl;
+    }
+
+    // 4. 异常沿着链往后传；接 Future<T> 的续体可以把它接住
+    {
+        Promise<int> p;
+        Future<int> recovered = p.get_future()
+            .then(pool, [](int x) { return x * 2; })                 // 上一步失败：这一步被跳过
+            .then([](Future<int> f) {
+                try {
+                    return f.get();
+                } catch (const std::exception& e) {
+                    std::cout << "续体接住异常: " << e.what() << std::endl;
+                    return -1;
+                }
+            });
+        p.set_exception(std::make_exception_ptr(std::runtime_error("db timeout")));
+        std::cout << "恢复后的值: " << recovered.get() << std::endl;
+
+        // 续体返回 Future 时自动展开
+        int nested = async_on(pool, [] { return 20; })
+            .then([&pool](int x) { return async_on(pool, [x] { return x + 1; }); })
+            .then([](int x) { return x * 2; })
+            .get();
+        std::cout << "展开嵌套 future: " << nested << std::endl;
+    }
+
+    // 5. DropOldest 的小池子：唯一的工人被堵住，续体比队列容量多得多，之后又灌进一堆普通任务；
+    //    被挤掉的只能是普通任务，续体一个都不能丢，否则 get() 永远等不到
+    {
+        ThreadPoolOptions small = ThreadPoolOptions::fixed(1);
+        small.queue_capacity = 8;
+        small.overflow_policy = OverflowPolicy::DropOldest;
+        ThreadPool drop_pool(small);
+
+        std::atomic<bool> gate{false};
+        drop_pool.enqueue([&gate] { while (!gate.load()) std::this_thread::yield(); });
+
+        const int M = 200;
+        std::vector<Promise<int>> promises(M);
+        std::vector<Future<int>> chains;
+        chains.reserve(M);
+        for (int i = 0; i < M; ++i) {
+            chains.push_back(promises[i].get_future().then(drop_pool, [](int x) { return x + 1; }));
+        }
+        for (int i = 0; i < M; ++i) promises[i].set_value(i); // 续体全部投进堵住的池子
+        for (int i = 0; i < 1000; ++i) drop_pool.enqueue([] {});
+        gate = true;
+
+        long long sum = 0;
+        for (int v : when_all(std::move(chains)).get()) sum += v;
+        std::cout << "DropOldest 池上 " << M << " 个续体: 结果和 " << sum << " (应为 "
+                  << static_cast<long long>(M) * (M + 1) / 2 << ")，被挤掉的普通任务 "
+                  << drop_pool.overflow_stats().dropped << " 个" << std::endl;
+    }
+
+    return 0;
+}
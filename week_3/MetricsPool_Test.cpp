@@ -0,0 +1,81 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <random>
+#include "ThreadPool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 测一下埋点本身的开销：线程池里 start 时间本来就要取（扩容判断要用），
+// 埋点额外多出来的只有结束时的一次 now() + 一次 record()
+void measure_record_cost() {
+    using Clock = std::chrono::steady_clock;
+    WorkerStats stats;
+    const int N = 1000000;
+
+    auto begin = Clock::now();
+    Clock::time_point start = begin;
+    Clock::time_point last_end = begin;
+    for (int i = 0; i < N; ++i) {
+        Clock::time_point end = Clock::now();
+        stats.record(static_cast<uint64_t>(i & 1023),
+                     static_cast<uint64_t>((end - start).count()),
+                     static_cast<uint64_t>((start - last_end).count()));
+        last_end = start;
+        start = end;
+    }
+    auto total = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin);
+    std::cout << "每个任务的埋点开销: " << static_cast<double>(total.count()) / N << " ns" << std::endl;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    measure_record_cost();
+
+    ThreadPool pool(4);
+    {
+        // 每 200ms 打印一次文本快照
+        MetricsDumper dumper(pool, std::chrono::milliseconds(200), std::cout);
+
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<> dis(1, 20);
+        for (int i = 0; i < 100; ++i) {
+            int ms = dis(gen);
+            pool.enqueue([ms] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    }
+
+    std::cout << "\n=== 最终快照 (JSON) ===" << std::endl;
+    std::cout << pool.metrics().to_json() << std::endl;
+
+    // 弹性池反复扩容、空闲退休：退休工人的统计并进一份汇总，快照里的工人条目不会越积越多
+    {
+        ThreadPoolOptions opt = ThreadPoolOptions::elastic(1, 4);
+        opt.idle_timeout = std::chrono::milliseconds(20);
+        ThreadPool elastic(opt);
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < 40; ++i) {
+                elastic.enqueue([] { std::this_thread::sleep_for(std::chrono::milliseconds(1)); });
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(80)); // 等多出来的工人退休
+        }
+        PoolMetricsSnapshot snap = elastic.metrics();
+        std::cout << "\n=== 10 轮突发之后 ===" << std::endl;
+        std::cout << "快照里的在职工人条目: " << snap.workers.size() << "，已退休 " << snap.retired_workers
+                  << " 个，总任务数 " << snap.total().tasks << " / 400" << std::endl;
+    }
+    return 0;
+}
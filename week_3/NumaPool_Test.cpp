@@ -0,0 +1,57 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include "NumaThreadPool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    // 1. 拓扑发现
+    auto nodes = CpuTopology::discover();
+    std::cout << "NUMA 节点数: " << nodes.size() << std::endl;
+    for (const auto& node : nodes) {
+        std::cout << "  node" << node.id << ": " << node.cpus.size() << " 个逻辑 CPU" << std::endl;
+    }
+
+    // 2. 每个节点一个子池，工人逐核绑定
+    NumaThreadPool pool(2);
+    std::mutex print_mtx;
+
+    for (size_t n = 0; n < pool.node_count(); ++n) {
+        for (int i = 0; i < 2; ++i) {
+            pool.enqueue_on_node(n, [n, &print_mtx] {
+                std::lock_guard<std::mutex> lock(print_mtx);
+                std::cout << "节点 " << n << " 的任务跑在 CPU " << CpuTopology::current_cpu() << std::endl;
+            });
+        }
+    }
+
+    // 3. 节点本地处理：在节点上分配并 first-touch，再在同一节点上求和
+    const size_t N = 1 << 22;
+    for (size_t n = 0; n < pool.node_count(); ++n) {
+        std::promise<long long> result;
+        auto fut = result.get_future();
+        pool.enqueue_on_node(n, [N, &result] {
+            std::vector<int> data(N, 1); // first-touch：页会落在当前节点
+            long long sum = std::accumulate(data.begin(), data.end(), 0LL);
+            result.set_value(sum);
+        });
+        std::cout << "节点 " << n << " 本地求和: " << fut.get() << std::endl;
+    }
+
+    return 0;
+}
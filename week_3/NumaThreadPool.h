@@ -0,0 +1,75 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_NUMATHREADPOOL_H
+#define CONCURRENCY_STUDY_NUMATHREADPOOL_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <unordered_map>
+
+#include "ThreadPool.h"
+#include "CpuTopology.h"
+
+// =========================
+// NUMA 感知线程池：每个 NUMA 节点一个子线程池，工人绑在本节点的核上
+// 任务可以指定节点执行，让“谁访问内存”和“内存在哪”落在同一个 socket 上
+// =========================
+class NumaThreadPool {
+public:
+    using Task = ThreadPool::Task;
+
+    // threads_per_node = 0 表示每个节点有几个核就开几个工人
+    explicit NumaThreadPool(size_t threads_per_node = 0, bool pin_per_core = true)
+            : nodes_(CpuTopology::discover())
+    {
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            const NumaNode& node = nodes_[i];
+            for (int cpu : node.cpus) cpu_to_node_[cpu] = i;
+
+            size_t n = threads_per_node == 0 ? node.cpus.size() : threads_per_node;
+            ThreadPoolOptions opt = ThreadPoolOptions::fixed(n);
+            opt.cpu_set = node.cpus;
+            opt.pin_per_core = pin_per_core;
+            pools_.push_back(std::make_unique<ThreadPool>(opt));
+        }
+    }
+
+    size_t node_count() const { return pools_.size(); }
+    const NumaNode& node(size_t index) const { return nodes_[index]; }
+    ThreadPool& pool(size_t index) { return *pools_[index]; }
+
+    // 指定节点执行（index 是 0..node_count()-1 的下标，不是 sysfs 里的 node id）
+    bool enqueue_on_node(size_t index, Task task) {
+        if (index >= pools_.size()) return false;
+        return pools_[index]->enqueue(std::move(task));
+    }
+
+    // 在调用者当前所在的节点执行：适合“刚在本节点 first-touch 了一块内存，后续处理也留在本地”
+    bool enqueue_local(Task task) {
+        return enqueue_on_node(current_node(), std::move(task));
+    }
+
+    // 不关心在哪：节点间轮转，把负载摊开
+    bool enqueue(Task task) {
+        size_t index = next_.fetch_add(1, std::memory_order_relaxed) % pools_.size();
+        return pools_[index]->enqueue(std::move(task));
+    }
+
+    // 调用线程当前所在节点的下标；拿不到 CPU 编号时返回 0
+    size_t current_node() const {
+        int cpu = CpuTopology::current_cpu();
+        auto it = cpu_to_node_.find(cpu);
+        return it == cpu_to_node_.end() ? 0 : it->second;
+    }
+
+private:
+    std::vector<NumaNode> nodes_;
+    std::unordered_map<int, size_t> cpu_to_node_;
+    std::vector<std::unique_ptr<ThreadPool>> pools_;
+    std::atomic<size_t> next_{0};
+};
+
+#endif //CONCURRENCY_STUDY_NUMATHREADPOOL_H
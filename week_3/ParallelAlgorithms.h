@@ -0,0 +1,288 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_PARALLELALGORITHMS_H
+#define CONCURRENCY_STUDY_PARALLELALGORITHMS_H
+
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <iterator>
+#include <type_traits>
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <exception>
+
+#include "ThreadPool.h"
+#include "WorkStealingPool.h"
+
+// =========================
+// 数据并行原语：parallel_for / parallel_reduce / parallel_inclusive_scan
+// 跑在一个常驻线程池上，不再像 day_5 那样按核心数“分批开线程”
+// pool 可以是 ThreadPool，也可以是 WorkStealingPool；没有自己的池就用 default_work_stealing_pool()，
+// 和排序共用同一套工人 —— 再开一个按核心数配满的常驻池，两边同时忙时线程数就是核心数的两倍
+// =========================
+
+namespace parallel_detail {
+
+// 自适应分块（guided self-scheduling）：
+// 每次从共享的原子游标上切走“剩余量 / (2 * 参与者数)”这么大一块，但不小于 min_grain。
+// 开始时块很大，轻量循环体几乎没有调度开销；快结束时块越来越小，重循环体也能把尾巴摊平。
+// 不需要调用者指定粒度。
+template<typename Body>
+struct ChunkState {
+    Body body;                     // body(slot, begin, end)
+    size_t n;
+    size_t participants;
+    size_t min_grain;
+    std::atomic<size_t> next{0};   // 下一个还没被领走的下标
+    std::atomic<size_t> done{0};   // 已经处理完的元素数
+    std::atomic<size_t> slots{1};  // 参与者编号分配，0 号留给调用者
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool finished = false;
+    std::exception_ptr error;      // 第一个抛出的异常（mtx 保护），调用者 wait() 之后重新抛出
+
+    ChunkState(Body b, size_t count, size_t p, size_t grain)
+            : body(std::move(b)), n(count), participants(p), min_grain(grain) {}
+
+    bool grab(size_t& begin, size_t& end) {
+        size_t cur = next.load(std::memory_order_relaxed);
+        while (cur < n) {
+            size_t remaining = n - cur;
+            size_t chunk = std::max(min_grain, remaining / (2 * participants));
+            chunk = std::min(chunk, remaining);
+            if (next.compare_exchange_weak(cur, cur + chunk, std::memory_order_relaxed)) {
+                begin = cur;
+                end = cur + chunk;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // body 抛异常：记下第一个，把游标推到末尾不再发新块，没发出去的元素直接记成“处理完”，
+    // 这样 wait() 照样能返回；不让异常飞出去 —— 帮手里飞出去会终止进程，
+    // 调用者里飞出去则会在帮手还在用 body（引用着调用者栈上的变量）时提前返回
+    void work(size_t slot) {
+        size_t begin = 0, end = 0;
+        while (grab(begin, end)) {
+            size_t count = end - begin;
+            try {
+                body(slot, begin, end);
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if (!error) error = std::current_exception();
+                }
+                count += n - next.exchange(n, std::memory_order_relaxed);
+            }
+            // release：本块的写入（包括归约的部分和）对最后等待的调用者可见
+            if (done.fetch_add(count, std::memory_order_acq_rel) + count == n) {
+                std::lock_guard<std::mutex> lock(mtx);
+                finished = true;
+                cv.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return finished; });
+    }
+};
+
+// 把 [0, n) 切块并行处理；body(slot, begin, end)，slot ∈ [0, participants)，同一个 slot 不会并发
+// 调用者自己也干活，并且只等“所有元素处理完”，不等帮手线程启动 ——
+// 所以在线程池工人里嵌套调用也不会死锁。body 抛出的第一个异常在所有块结束后由调用者重新抛出
+template<typename Body>
+void run_chunks(ThreadPool& pool, size_t n, size_t participants, size_t min_grain, Body body) {
+    if (n == 0) return;
+    if (participants <= 1 || n <= min_grain) {
+        body(0, 0, n);
+        return;
+    }
+
+    auto state = std::make_shared<ChunkState<Body>>(std::move(body), n, participants, min_grain);
+    for (size_t i = 1; i < participants; ++i) {
+        // 帮手提交失败（队列满）也没关系，剩下的活调用者自己干
+        bool ok = pool.try_enqueue([state]() {
+            size_t slot = state->slots.fetch_add(1, std::memory_order_relaxed);
+            state->work(slot);
+        });
+        if (!ok) break;
+    }
+    state->work(0);
+    state->wait();
+    // 已经没人再碰 body，可以放心展开；异常对象移出来，不让最后释放 state 的帮手线程去析构它
+    if (std::exception_ptr error = std::move(state->error)) std::rethrow_exception(error);
+}
+
+inline size_t participants_for(ThreadPool& pool, size_t n, size_t min_grain) {
+    size_t p = pool.thread_count() + 1; // 工人 + 调用者
+    size_t by_size = (n + min_grain - 1) / min_grain;
+    return std::max<size_t>(1, std::min(p, by_size));
+}
+
+// 工作窃取池上：参与者就是 fork 出去的 participants 个子任务，每个子任务领一个 slot 去抢块。
+// 外部线程调用时阻塞在 run() 里不干活；工人里调用时自己就是其中一个子任务，边等边偷
+// NOLINTNEXTLINE(misc-no-recursion)
+template<typename F>
+void fork_slots(WorkStealingPool& pool, size_t lo, size_t hi, F& f) {
+    if (hi - lo == 1) {
+        f(lo);
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    pool.join([&]() { fork_slots(pool, lo, mid, f); }, [&]() { fork_slots(pool, mid, hi, f); });
+}
+
+template<typename Body>
+void run_chunks(WorkStealingPool& pool, size_t n, size_t participants, size_t min_grain, Body body) {
+    if (n == 0) return;
+    if (participants <= 1 || n <= min_grain) {
+        body(0, 0, n);
+        return;
+    }
+    // join 返回时所有子任务都结束了，状态放在栈上就行
+    ChunkState<Body> state(std::move(body), n, participants, min_grain);
+    auto slot = [&state](size_t s) { state.work(s); };
+    pool.run([&]() { fork_slots(pool, 0, participants, slot); });
+    if (state.error) std::rethrow_exception(state.error);
+}
+
+inline size_t participants_for(WorkStealingPool& pool, size_t n, size_t min_grain) {
+    size_t by_size = (n + min_grain - 1) / min_grain;
+    return std::max<size_t>(1, std::min(pool.thread_count(), by_size));
+}
+
+} // namespace parallel_detail
+
+// =========================
+// parallel_for(pool, first, last, f)
+//   first/last 是整数：f(i)，i ∈ [first, last)
+//   first/last 是随机访问迭代器：f(*it)
+// =========================
+template<typename Pool, typename I, typename F>
+void parallel_for(Pool& pool, I first, I last, F f, size_t min_grain = 1) {
+    if (!(first < last)) return;
+    size_t n = static_cast<size_t>(last - first);
+    size_t participants = parallel_detail::participants_for(pool, n, min_grain);
+
+    parallel_detail::run_chunks(pool, n, participants, min_grain,
+        [first, &f](size_t, size_t b, size_t e) {
+            if constexpr (std::is_integral_v<I>) {
+                for (size_t i = b; i < e; ++i) f(static_cast<I>(first + static_cast<I>(i)));
+            } else {
+                for (I it = first + b, end = first + e; it != end; ++it) f(*it);
+            }
+        });
+}
+
+// =========================
+// parallel_transform_reduce(pool, first, last, identity, op, transform)
+//   归约 op(acc, transform(x))；x 是 *it（迭代器）或下标 i（整数）
+//   op 只需要满足结合律（不要求交换律，字符串拼接、矩阵乘都行），identity 是它的单位元
+// parallel_reduce(pool, first, last, identity, op) 就是 transform 取恒等
+// =========================
+template<typename Pool, typename I, typename T, typename Op, typename Transform>
+T parallel_transform_reduce(Pool& pool, I first, I last, T identity, Op op, Transform transform,
+                            size_t min_grain = 1024) {
+    if (!(first < last)) return identity;
+    size_t n = static_cast<size_t>(last - first);
+    size_t participants = parallel_detail::participants_for(pool, n, min_grain);
+
+    // 每块一个部分和，记下块的起点：哪个参与者抢到哪块是随机的，最后按起点排好再按顺序合并，
+    // 这样只用到结合律；块的切法只由 n 决定，浮点求和每次结果也一样。
+    // 每个参与者一个列表，按缓存行隔开，避免伪共享；块数是 O(参与者数 × log n)，排序不值一提
+    struct alignas(64) Partial { std::vector<std::pair<size_t, T>> chunks; };
+    std::vector<Partial> partials(participants);
+
+    parallel_detail::run_chunks(pool, n, participants, min_grain,
+        [first, &partials, &op, &transform, &identity](size_t slot, size_t b, size_t e) {
+            T acc = identity;
+            if constexpr (std::is_integral_v<I>) {
+                for (size_t i = b; i < e; ++i) {
+                    acc = op(std::move(acc), transform(static_cast<I>(first + static_cast<I>(i))));
+                }
+            } else {
+                for (I it = first + b, end = first + e; it != end; ++it) {
+                    acc = op(std::move(acc), transform(*it));
+                }
+            }
+            partials[slot].chunks.emplace_back(b, std::move(acc));
+        });
+
+    std::vector<std::pair<size_t, T>*> ordered;
+    for (auto& p : partials) {
+        for (auto& c : p.chunks) ordered.push_back(&c);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const auto* x, const auto* y) { return x->first < y->first; });
+    T result = std::move(identity);
+    for (auto* c : ordered) result = op(std::move(result), std::move(c->second));
+    return result;
+}
+
+template<typename Pool, typename It, typename T, typename Op>
+T parallel_reduce(Pool& pool, It first, It last, T identity, Op op, size_t min_grain = 1024) {
+    return parallel_transform_reduce(pool, first, last, identity, op,
+                                     [](const auto& x) { return x; }, min_grain);
+}
+
+// =========================
+// parallel_inclusive_scan(pool, first, last, d_first, op)
+// 经典三步：1) 各块并行求块内总和  2) 串行对块和做前缀  3) 各块带着偏移量并行扫描
+// 每个元素被读两次、写一次；op 需要满足结合律。返回输出的尾后迭代器
+// =========================
+template<typename Pool, typename InIt, typename OutIt, typename Op>
+OutIt parallel_inclusive_scan(Pool& pool, InIt first, InIt last, OutIt d_first, Op op,
+                              size_t min_grain = 4096) {
+    using T = typename std::iterator_traits<InIt>::value_type;
+    if (!(first < last)) return d_first;
+    size_t n = static_cast<size_t>(last - first);
+
+    size_t participants = parallel_detail::participants_for(pool, n, min_grain);
+    if (participants <= 1) {
+        T acc = *first;
+        *d_first = acc;
+        for (size_t i = 1; i < n; ++i) {
+            acc = op(acc, first[i]);
+            d_first[i] = acc;
+        }
+        return d_first + n;
+    }
+
+    // 块数取参与者的几倍，让第 1、3 步也能负载均衡
+    size_t blocks = std::min(n, participants * 4);
+    size_t block_size = (n + blocks - 1) / blocks;
+    blocks = (n + block_size - 1) / block_size;
+
+    std::vector<T> block_sum(blocks);
+    parallel_for(pool, size_t{0}, blocks, [&](size_t k) {
+        size_t b = k * block_size, e = std::min(n, b + block_size);
+        T acc = first[b];
+        for (size_t i = b + 1; i < e; ++i) acc = op(acc, first[i]);
+        block_sum[k] = acc;
+    });
+
+    // block_sum[k] 变成前 k+1 块的总和
+    for (size_t k = 1; k < blocks; ++k) block_sum[k] = op(block_sum[k - 1], block_sum[k]);
+
+    parallel_for(pool, size_t{0}, blocks, [&](size_t k) {
+        size_t b = k * block_size, e = std::min(n, b + block_size);
+        T acc = (k == 0) ? T(first[b]) : op(block_sum[k - 1], first[b]);
+        d_first[b] = acc;
+        for (size_t i = b + 1; i < e; ++i) {
+            acc = op(acc, first[i]);
+            d_first[i] = acc;
+        }
+    });
+    return d_first + n;
+}
+
+#endif //CONCURRENCY_STUDY_PARALLELALGORITHMS_H
@@ -0,0 +1,110 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <cmath>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <atomic>
+#include <stdexcept>
+#include "ParallelAlgorithms.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+template<typename F>
+long long time_ms(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    WorkStealingPool& pool = default_work_stealing_pool();
+    std::cout << "常驻工作窃取池工人数: " << pool.thread_count() << std::endl;
+
+    // 1. 轻量循环体：对 5000 万个 int 求和
+    const size_t N = 50000000;
+    std::vector<int> data(N);
+    parallel_for(pool, size_t{0}, N, [&data](size_t i) { data[i] = static_cast<int>(i % 100); });
+
+    long long seq_sum = 0, par_sum = 0;
+    auto t_seq = time_ms([&] { seq_sum = std::accumulate(data.begin(), data.end(), 0LL); });
+    auto t_par = time_ms([&] {
+        par_sum = parallel_reduce(pool, data.begin(), data.end(), 0LL,
+                                  [](long long a, long long b) { return a + b; });
+    });
+    std::cout << "[轻量] 求和  串行: " << t_seq << " ms  并行: " << t_par << " ms  结果"
+              << (seq_sum == par_sum ? "一致" : "不一致!") << std::endl;
+
+    // 2. 重循环体：每个元素做一串超越函数，且越往后越重（考验尾部负载均衡）
+    const size_t M = 20000;
+    std::vector<double> heavy(M);
+    auto body = [&heavy](size_t i) {
+        double x = 0;
+        for (size_t k = 0; k < 200 + i / 10; ++k) x += std::sin(static_cast<double>(k + i));
+        heavy[i] = x;
+    };
+    t_seq = time_ms([&] { for (size_t i = 0; i < M; ++i) body(i); });
+    t_par = time_ms([&] { parallel_for(pool, size_t{0}, M, body); });
+    std::cout << "[重载] 循环  串行: " << t_seq << " ms  并行: " << t_par << " ms" << std::endl;
+
+    // 3. 前缀和
+    std::vector<long long> in(N), out_seq(N), out_par(N);
+    parallel_for(pool, in.begin(), in.end(), [](long long& x) { x = 1; });
+    t_seq = time_ms([&] { std::partial_sum(in.begin(), in.end(), out_seq.begin()); });
+    t_par = time_ms([&] { parallel_inclusive_scan(pool, in.begin(), in.end(), out_par.begin(), std::plus<>()); });
+    std::cout << "[扫描] 前缀和 串行: " << t_seq << " ms  并行: " << t_par << " ms  结果"
+              << (out_seq == out_par ? "一致" : "不一致!") << std::endl;
+
+    // 4. 只满足结合律、不满足交换律的归约：字符串拼接，结果必须和串行一样按原顺序
+    {
+        const size_t K = 200000;
+        std::vector<std::string> words(K);
+        for (size_t i = 0; i < K; ++i) words[i] = std::to_string(i % 1000) + ",";
+        std::string seq_cat;
+        for (const auto& w : words) seq_cat += w;
+        std::string par_cat = parallel_reduce(pool, words.begin(), words.end(), std::string(),
+                                              [](std::string a, const std::string& b) {
+                                                  a += b;
+                                                  return a;
+                                              });
+        std::cout << "[拼接] 20 万个字符串 结果" << (seq_cat == par_cat ? "一致" : "不一致!") << std::endl;
+    }
+
+    // 5. 循环体抛异常：不管是调用者还是帮手抛的，都等所有块停下来后在调用者这里重新抛出
+    {
+        std::atomic<size_t> visited{0};
+        std::string caught = "没抛出!";
+        try {
+            parallel_for(pool, size_t{0}, size_t{10000000}, [&visited](size_t i) {
+                visited.fetch_add(1, std::memory_order_relaxed);
+                if (i == 7654321) throw std::runtime_error("第 7654321 个元素出错");
+            });
+        } catch (const std::exception& e) {
+            caught = e.what();
+        }
+        std::cout << "[异常] " << caught << "，停下前处理了 " << visited.load() << " / 10000000 个元素" << std::endl;
+    }
+
+    // 6. 已经有自己的 ThreadPool 时也可以直接传进来：调用者也算一个参与者
+    {
+        ThreadPool own(ThreadPoolOptions::fixed(4));
+        long long own_sum = parallel_reduce(own, data.begin(), data.end(), 0LL,
+                                            [](long long a, long long b) { return a + b; });
+        std::cout << "[ThreadPool] 求和结果" << (own_sum == seq_sum ? "一致" : "不一致!") << std::endl;
+    }
+
+    return 0;
+}
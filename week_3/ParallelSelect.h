@@ -0,0 +1,231 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_PARALLELSELECT_H
+#define CONCURRENCY_STUDY_PARALLELSELECT_H
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#include "ParallelSort.h"
+
+// =========================
+// 并行选择：只要前 k 个 / 中位数的时候，不必把全部数据排一遍
+//   parallel_top_k：每块数据一个容量为 k 的堆（堆顶是目前留下的最差者），
+//     随机数据上绝大多数元素和堆顶比一次就被丢掉，只读不写；最后把各块的候选合起来选前 k 个
+//   parallel_nth_element：抽样选两个“夹住”目标名次的枢轴（Floyd-Rivest 的思路），
+//     并行三路划分 [< 低枢轴][两枢轴之间][> 高枢轴]，目标几乎总落在很窄的中间段，
+//     一趟就把问题缩小到百分之几，剩下的交给 std::nth_element
+//   parallel_partial_sort：nth_element 定出前 k 个，再把它们并行排好
+// 比较器都是严格弱序，“前 k 个”指 comp 序下最靠前的 k 个：要最大的 k 个就传 std::greater<>()
+// =========================
+
+namespace select_detail {
+
+constexpr size_t kSequential = size_t(1) << 16; // 比这短就直接用标准库的顺序版本
+constexpr size_t kSample = 16384;
+
+// 每块一个有界堆，返回各块候选拼起来的数组（每块至多 k 个）
+template<typename RandomIt, typename Compare>
+std::vector<typename std::iterator_traits<RandomIt>::value_type>
+block_candidates(WorkStealingPool& pool, RandomIt data, size_t n, size_t k, Compare& comp) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using D = std::ptrdiff_t;
+
+    // 每块至少 8k 个元素，否则堆的建立和最后的合并就不划算了
+    size_t blocks = std::max<size_t>(1, std::min(pool.thread_count() * 4, n / std::max(k * 8, size_t(16384))));
+    auto block_lo = [&](size_t b) { return n * b / blocks; };
+    std::vector<std::vector<T>> heaps(blocks);
+
+    auto scan = [&](size_t b) {
+        size_t lo = block_lo(b), hi = block_lo(b + 1);
+        size_t first = std::min(hi, lo + k);
+        auto& heap = heaps[b];
+        heap.assign(data + static_cast<D>(lo), data + static_cast<D>(first));
+        std::make_heap(heap.begin(), heap.end(), comp); // 堆顶是 comp 序下最靠后的
+        for (size_t i = first; i < hi; ++i) {
+            const T& x = data[static_cast<D>(i)];
+            if (comp(x, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), comp);
+                heap.back() = x;
+                std::push_heap(heap.begin(), heap.end(), comp);
+            }
+        }
+    };
+    sort_detail::fork_each(pool, 0, blocks, scan);
+
+    std::vector<T> all;
+    all.reserve(blocks * k);
+    for (auto& h : heaps) std::move(h.begin(), h.end(), std::back_inserter(all));
+    return all;
+}
+
+// 在 data[0, n) 里就地把第 nth 个放到位：前面的都不大于它，后面的都不小于它
+template<typename RandomIt, typename Compare>
+void nth_element(WorkStealingPool& pool, RandomIt data, size_t n, size_t nth, Compare& comp) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using D = std::ptrdiff_t;
+
+    // 调用方保证 n > kSequential，循环至少走一趟；两块临时区都不串行清零，第一次写在分类 / 散射里
+    sort_detail::ScratchBuffer<T> scratch(pool, n, data);
+    std::unique_ptr<uint8_t[]> oracle(new uint8_t[n]);
+    size_t lo = 0, hi = n; // nth 所在、还没排好的区间
+    std::mt19937_64 gen(n); // 固定种子：同样的输入每次划分一样
+
+    while (hi - lo > kSequential) {
+        size_t m = hi - lo;
+        size_t rank = nth - lo;
+        RandomIt base = data + static_cast<D>(lo);
+
+        // 1. 抽 s 个样本排好；目标名次在样本里大约排第 r，左右各让出 3 个标准差取两个枢轴
+        size_t s = std::min(kSample, m / 16);
+        std::vector<T> sample;
+        sample.reserve(s);
+        std::uniform_int_distribution<size_t> pick(0, m - 1);
+        for (size_t i = 0; i < s; ++i) sample.push_back(base[static_cast<D>(pick(gen))]);
+        std::sort(sample.begin(), sample.end(), comp);
+        size_t r = static_cast<size_t>(static_cast<double>(rank) / static_cast<double>(m) * static_cast<double>(s));
+        size_t delta = static_cast<size_t>(3 * std::sqrt(static_cast<double>(s)));
+        const T low = sample[r > delta ? r - delta : 0];
+        const T high = sample[std::min(s - 1, r + delta)];
+
+        // 2. 分类：0 = 小于 low，1 = 夹在中间，2 = 大于 high；每块数三个桶
+        size_t blocks = std::max<size_t>(1, std::min(pool.thread_count() * 4, m / 16384));
+        auto block_lo = [&](size_t b) { return m * b / blocks; };
+        std::vector<std::array<size_t, 3>> counts(blocks);
+        auto classify = [&](size_t b) {
+            std::array<size_t, 3> c{};
+            for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) {
+                const T& x = base[static_cast<D>(i)];
+                uint8_t bucket = comp(x, low) ? 0 : (comp(high, x) ? 2 : 1);
+                oracle[i] = bucket;
+                ++c[bucket];
+            }
+            counts[b] = c;
+        };
+        sort_detail::fork_each(pool, 0, blocks, classify);
+
+        // 3. 前缀和 → 每块每桶的写入起点；散射到 scratch，再并行搬回
+        size_t size[3] = {0, 0, 0};
+        size_t running = 0;
+        for (size_t bucket = 0; bucket < 3; ++bucket) {
+            for (size_t b = 0; b < blocks; ++b) {
+                size_t c = counts[b][bucket];
+                counts[b][bucket] = running;
+                running += c;
+                size[bucket] += c;
+            }
+        }
+        auto scatter = [&](size_t b) {
+            auto& offset = counts[b];
+            for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) {
+                scratch[offset[oracle[i]]++] = std::move(base[static_cast<D>(i)]);
+            }
+        };
+        sort_detail::fork_each(pool, 0, blocks, scatter);
+        auto move_back = [&](size_t b) {
+            std::move(scratch.data() + block_lo(b), scratch.data() + block_lo(b + 1), base + static_cast<D>(block_lo(b)));
+        };
+        sort_detail::fork_each(pool, 0, blocks, move_back);
+
+        // 4. 目标落在哪一段就只管那一段；中间段两个枢轴相等时里面全是同一个值，已经到位
+        if (rank < size[0]) {
+            hi = lo + size[0];
+        } else if (rank < size[0] + size[1]) {
+            lo += size[0];
+            hi = lo + size[1];
+            if (!comp(low, high)) return;
+        } else {
+            lo += size[0] + size[1];
+        }
+        if (hi - lo == m) break; // 一点没缩小（枢轴恰好抽到两端），别再抽了
+    }
+    std::nth_element(data + static_cast<D>(lo), data + static_cast<D>(nth), data + static_cast<D>(hi), comp);
+}
+
+} // namespace select_detail
+
+// =========================
+// parallel_nth_element(pool, begin, nth, end, comp)
+// 和 std::nth_element 一样：*nth 是排好序后应在那个位置的元素，[begin, nth) 都不在它后面，(nth, end) 都不在它前面
+// 额外占用 n 个元素 + n 字节的临时空间
+// =========================
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_nth_element(WorkStealingPool& pool, RandomIt begin, RandomIt nth, RandomIt end, Compare comp = Compare()) {
+    auto n = static_cast<size_t>(std::distance(begin, end));
+    auto k = static_cast<size_t>(std::distance(begin, nth));
+    if (k >= n) return;
+    if (n <= select_detail::kSequential) {
+        std::nth_element(begin, nth, end, comp);
+        return;
+    }
+    pool.run([&]() { select_detail::nth_element(pool, begin, n, k, comp); });
+}
+
+// =========================
+// parallel_partial_sort(pool, begin, middle, end, comp)
+// 和 std::partial_sort 一样：[begin, middle) 是 comp 序下最靠前的 middle - begin 个，并且排好序；其余的顺序不定
+// =========================
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_partial_sort(WorkStealingPool& pool, RandomIt begin, RandomIt middle, RandomIt end,
+                           Compare comp = Compare()) {
+    if (begin == middle) return;
+    parallel_nth_element(pool, begin, middle, end, comp);
+    parallel_merge_sort(pool, begin, middle, comp);
+}
+
+// =========================
+// parallel_top_k(pool, begin, end, k, comp)
+// 返回 comp 序下最靠前的 k 个（不足 k 个就全部），已排好序；输入只读不改
+// k 远小于 n 时走“每块一个有界堆”；k 和 n 相当时堆不划算，拷一份做 partial_sort
+// =========================
+template<typename RandomIt, typename Compare = std::less<>>
+std::vector<typename std::iterator_traits<RandomIt>::value_type>
+parallel_top_k(WorkStealingPool& pool, RandomIt begin, RandomIt end, size_t k, Compare comp = Compare()) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    auto n = static_cast<size_t>(std::distance(begin, end));
+    k = std::min(k, n);
+    if (k == 0) return {};
+
+    std::vector<T> result;
+    if (k > n / 64) {
+        result.assign(begin, end);
+        parallel_partial_sort(pool, result.begin(), result.begin() + static_cast<std::ptrdiff_t>(k), result.end(), comp);
+        result.resize(k);
+        return result;
+    }
+    pool.run([&]() { result = select_detail::block_candidates(pool, begin, n, k, comp); });
+    auto kth = result.begin() + static_cast<std::ptrdiff_t>(k);
+    std::nth_element(result.begin(), kth, result.end(), comp);
+    result.erase(kth, result.end());
+    std::sort(result.begin(), result.end(), comp);
+    return result;
+}
+
+// 用默认工作窃取池
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_nth_element(RandomIt begin, RandomIt nth, RandomIt end, Compare comp = Compare()) {
+    parallel_nth_element(default_work_stealing_pool(), begin, nth, end, comp);
+}
+
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_partial_sort(RandomIt begin, RandomIt middle, RandomIt end, Compare comp = Compare()) {
+    parallel_partial_sort(default_work_stealing_pool(), begin, middle, end, comp);
+}
+
+template<typename RandomIt, typename Compare = std::less<>>
+std::vector<typename std::iterator_traits<RandomIt>::value_type>
+parallel_top_k(RandomIt begin, RandomIt end, size_t k, Compare comp = Compare()) {
+    return parallel_top_k(default_work_stealing_pool(), begin, end, k, comp);
+}
+
+#endif //CONCURRENCY_STUDY_PARALLELSELECT_H
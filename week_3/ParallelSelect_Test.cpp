@@ -0,0 +1,116 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "ParallelSelect.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void line(const std::string& name, double base, double ms, bool ok) {
+    std::cout << name << ": 标准库 " << std::setw(8) << base << " ms，并行 " << std::setw(8) << ms << " ms ("
+              << base / ms << "x)" << (ok ? "" : " 结果不对!") << std::endl;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    std::cout << std::fixed << std::setprecision(2);
+    WorkStealingPool& pool = default_work_stealing_pool();
+    std::cout << "工人数: " << pool.thread_count() << std::endl;
+
+    const size_t N = 50000000;
+    std::mt19937_64 gen(42);
+    std::vector<int64_t> source(N);
+    for (auto& x : source) x = static_cast<int64_t>(gen() >> 1);
+
+    // 0. 对照：全部排一遍（TurboSort 的做法）
+    std::vector<int64_t> sorted = source;
+    auto start = Clock::now();
+    parallel_merge_sort(pool, sorted.begin(), sorted.end());
+    std::cout << "5000 万 int64 全部排序: " << ms_since(start) << " ms" << std::endl;
+
+    // 1. 最大的 1000 个：std::partial_sort 在副本上做 vs 每块一个有界堆（输入不动）
+    {
+        const size_t K = 1000;
+        std::vector<int64_t> expect(sorted.rbegin(), sorted.rbegin() + K);
+
+        std::vector<int64_t> data = source;
+        start = Clock::now();
+        std::partial_sort(data.begin(), data.begin() + K, data.end(), std::greater<>());
+        double base = ms_since(start);
+        bool ok = std::equal(expect.begin(), expect.end(), data.begin());
+
+        start = Clock::now();
+        std::vector<int64_t> top = parallel_top_k(pool, source.begin(), source.end(), K, std::greater<>());
+        double ms = ms_since(start);
+        line("top 1000 (最大)       ", base, ms, ok && top == expect);
+    }
+
+    // 2. 中位数
+    {
+        size_t mid = N / 2;
+        std::vector<int64_t> data = source;
+        start = Clock::now();
+        std::nth_element(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(mid), data.end());
+        double base = ms_since(start);
+        bool ok = data[mid] == sorted[mid];
+
+        data = source;
+        start = Clock::now();
+        parallel_nth_element(pool, data.begin(), data.begin() + static_cast<std::ptrdiff_t>(mid), data.end());
+        double ms = ms_since(start);
+        ok = ok && data[mid] == sorted[mid] &&
+             std::all_of(data.begin(), data.begin() + static_cast<std::ptrdiff_t>(mid), [&](int64_t x) { return x <= data[mid]; }) &&
+             std::all_of(data.begin() + static_cast<std::ptrdiff_t>(mid), data.end(), [&](int64_t x) { return x >= data[mid]; });
+        line("nth_element (中位数)  ", base, ms, ok);
+    }
+
+    // 3. 前 10% 排好序
+    {
+        auto middle = static_cast<std::ptrdiff_t>(N / 10);
+        std::vector<int64_t> data = source;
+        start = Clock::now();
+        std::partial_sort(data.begin(), data.begin() + middle, data.end());
+        double base = ms_since(start);
+        bool ok = std::equal(data.begin(), data.begin() + middle, sorted.begin());
+
+        data = source;
+        start = Clock::now();
+        parallel_partial_sort(pool, data.begin(), data.begin() + middle, data.end());
+        double ms = ms_since(start);
+        line("partial_sort (前 10%) ", base, ms, ok && std::equal(data.begin(), data.begin() + middle, sorted.begin()));
+    }
+
+    // 4. 大量重复值：只有 5 种取值时中位数落进“两枢轴相等”的段，一趟就结束
+    {
+        std::vector<int> data(N);
+        for (auto& x : data) x = static_cast<int>(gen() % 5);
+        std::vector<int> copy = data;
+        size_t mid = N / 2;
+        std::nth_element(copy.begin(), copy.begin() + static_cast<std::ptrdiff_t>(mid), copy.end());
+        start = Clock::now();
+        parallel_nth_element(pool, data.begin(), data.begin() + static_cast<std::ptrdiff_t>(mid), data.end());
+        std::cout << "5 种取值的中位数: " << ms_since(start) << " ms" << (data[mid] == copy[mid] ? "" : " 结果不对!") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,420 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_PARALLELSORT_H
+#define CONCURRENCY_STUDY_PARALLELSORT_H
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <cstddef>
+
+#include "WorkStealingPool.h"
+#include "SortingNetwork.h"
+
+// =========================
+// 并行排序
+// week_2/day4_task1_TurboSort.cpp 里的 parallel_merge_sort 每次切分都 std::async 一次：
+// 要么真的开一个系统线程，要么（实现允许的话）悄悄变成 deferred 串行执行；
+// 1000 / 100000 两个阈值也是写死的。这里改成常驻工作窃取池上的 fork-join，
+// 叶子大小按元素数和工人数自动定
+// =========================
+
+namespace sort_detail {
+
+// 叶子粒度：让每个工人平均分到 ~16 片叶子，偷任务时有足够的余量把不均摊平；
+// 下限保证 fork 的开销（几十纳秒）相对叶子排序可以忽略，上限让小池子也能切得开
+inline size_t auto_grain(size_t n, size_t workers) {
+    const size_t kMinGrain = 4096;
+    const size_t kMaxGrain = size_t(1) << 20;
+    size_t g = n / (workers * 16 + 1);
+    return std::min(kMaxGrain, std::max(kMinGrain, g));
+}
+
+// 对 [lo, hi) 里的每个 i 并行调用 f(i)：二分 fork，直到只剩一个
+// NOLINTNEXTLINE(misc-no-recursion)
+template<typename F>
+void fork_each(WorkStealingPool& pool, size_t lo, size_t hi, F& f) {
+    if (hi - lo == 1) {
+        f(lo);
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    pool.join([&]() { fork_each(pool, lo, mid, f); }, [&]() { fork_each(pool, mid, hi, f); });
+}
+
+// 排序用的临时区：n 个 T 的原始内存，不像 std::vector<T>(n) 那样在调用线程里串行清零。
+// 平凡类型不初始化（和 RadixSort 的 new T[n] 一样），第一次写入发生在各工人的叶子 / 合并里，缺页也是并行的；
+// 其他类型要先有对象才能被赋值，这里分块并行构造：能默认构造就默认构造，不能就从 src 拷贝一份
+template<typename T>
+class ScratchBuffer {
+public:
+    template<typename It>
+    ScratchBuffer(WorkStealingPool& pool, size_t n, It src)
+            : pool_(pool), n_(n), data_(std::allocator<T>().allocate(n)) {
+        if constexpr (!std::is_trivially_default_constructible_v<T>) {
+            for_chunks([this, src](size_t lo, size_t hi) {
+                if constexpr (std::is_default_constructible_v<T>) {
+                    std::uninitialized_default_construct(data_ + lo, data_ + hi);
+                } else {
+                    std::uninitialized_copy(src + static_cast<std::ptrdiff_t>(lo),
+                                            src + static_cast<std::ptrdiff_t>(hi), data_ + lo);
+                }
+            });
+        }
+    }
+
+    ~ScratchBuffer() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for_chunks([this](size_t lo, size_t hi) { std::destroy(data_ + lo, data_ + hi); });
+        }
+        std::allocator<T>().deallocate(data_, n_);
+    }
+
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    T* data() { return data_; }
+    T& operator[](size_t i) { return data_[i]; }
+
+private:
+    template<typename F>
+    void for_chunks(F f) {
+        size_t grain = auto_grain(n_, pool_.thread_count());
+        size_t parts = (n_ + grain - 1) / grain;
+        if (parts <= 1) {
+            f(0, n_);
+            return;
+        }
+        auto body = [&](size_t p) { f(p * grain, std::min(n_, (p + 1) * grain)); };
+        pool_.run([&]() { fork_each(pool_, 0, parts, body); });
+    }
+
+    WorkStealingPool& pool_;
+    size_t n_;
+    T* data_;
+};
+
+// 协同秩 (co-rank)：合并 A[0,m) 和 B[0,n) 时，输出的前 k 个元素里有几个来自 A
+// 相等时 A 的先出（和 std::merge 一样，保持稳定）。二分 O(log min(m, n))
+template<typename ItA, typename ItB, typename Compare>
+size_t co_rank(size_t k, ItA a, size_t m, ItB b, size_t n, Compare& comp) {
+    size_t lo = k > n ? k - n : 0;
+    size_t hi = std::min(k, m);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+        // A[i] 不大于 B[j-1]：A[i] 应该排在 B[j-1] 之前，说明 A 拿少了
+        if (j > 0 && !comp(b[j - 1], a[i])) {
+            lo = i + 1;
+        } else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+// 并行合并：输出按 parts 等分，每一段的起点用 co_rank 在两个输入里各二分一次，
+// 各段互不重叠，并行做普通的串行合并。
+// 输入可能是 move_iterator：std::string 这类元素被别的段移走后就空了，
+// 所以先把所有分段点算完，再开始合并，二分时不会读到已经搬空的元素
+template<typename ItA, typename ItB, typename OutIt, typename Compare>
+void merge_parts(WorkStealingPool& pool, ItA a, size_t m, ItB b, size_t n, OutIt out, Compare& comp, size_t grain) {
+    size_t total = m + n;
+    size_t parts = std::max<size_t>(1, (total + grain - 1) / grain);
+    std::vector<size_t> split(parts + 1);
+    auto rank = [&](size_t p) { split[p] = co_rank(total * p / parts, a, m, b, n, comp); };
+    fork_each(pool, 0, parts + 1, rank);
+    auto body = [&](size_t p) {
+        size_t k_lo = total * p / parts;
+        size_t k_hi = total * (p + 1) / parts;
+        size_t i_lo = split[p], i_hi = split[p + 1];
+        std::merge(a + static_cast<std::ptrdiff_t>(i_lo), a + static_cast<std::ptrdiff_t>(i_hi),
+                   b + static_cast<std::ptrdiff_t>(k_lo - i_lo), b + static_cast<std::ptrdiff_t>(k_hi - i_hi),
+                   out + static_cast<std::ptrdiff_t>(k_lo), comp);
+    };
+    fork_each(pool, 0, parts, body);
+}
+
+// =========================
+// 乒乓归并：数据（0 号缓冲）和一块同样大小的 scratch（1 号缓冲）轮流当源和目的，
+// 每一层只合并一次、不再搬回去，整个排序只分配（或借用）这一块 scratch。
+// Runs 描述“两块缓冲里存的是什么”，要提供：
+//   key(b, i)                          b 号缓冲第 i 个元素的键（co_rank 用）
+//   leaf(lo, hi, dst)                  把 [lo, hi) 串行排好，结果放在 dst 号缓冲（输入总在 0 号）
+//   merge(from, a_lo, a_hi, b_lo, b_hi, out)   from 号缓冲里的两段合并到另一块缓冲的 out 处
+//   comp                               比较器指针
+// =========================
+
+// 把 Runs 的某一块缓冲从 base 开始看成一个可下标访问的序列，给 co_rank 用
+template<typename Runs>
+struct KeyView {
+    const Runs* runs;
+    int buf;
+    size_t base;
+
+    decltype(auto) operator[](size_t i) const { return runs->key(buf, base + i); }
+};
+
+// from 号缓冲里相邻的两段 [lo, mid) 和 [mid, hi) 并行合并到另一块缓冲的 [lo, hi)
+template<typename Runs>
+void merge_runs(WorkStealingPool& pool, Runs& runs, int from, size_t lo, size_t mid, size_t hi, size_t grain) {
+    size_t m = mid - lo, n = hi - mid, total = hi - lo;
+    size_t parts = std::max<size_t>(1, (total + grain - 1) / grain);
+    KeyView<Runs> a{&runs, from, lo}, b{&runs, from, mid};
+    // 合并是“移动”出源缓冲的：std::string 这类元素被移走后就变了样，
+    // 所以先把所有分段点算完，再开始合并，二分时不会读到别的段已经搬空的元素
+    std::vector<size_t> split(parts + 1);
+    auto rank = [&](size_t p) { split[p] = co_rank(total * p / parts, a, m, b, n, *runs.comp); };
+    fork_each(pool, 0, parts + 1, rank);
+    auto body = [&](size_t p) {
+        size_t k_lo = total * p / parts;
+        size_t k_hi = total * (p + 1) / parts;
+        size_t i_lo = split[p], i_hi = split[p + 1];
+        runs.merge(from, lo + i_lo, lo + i_hi, mid + (k_lo - i_lo), mid + (k_hi - i_hi), lo + k_lo);
+    };
+    fork_each(pool, 0, parts, body);
+}
+
+// 排好 [lo, hi)，结果放在 dst 号缓冲：两半先排到另一块缓冲里，再合并回 dst
+// NOLINTNEXTLINE(misc-no-recursion)
+template<typename Runs>
+void pingpong_sort(WorkStealingPool& pool, Runs& runs, size_t lo, size_t hi, int dst, size_t grain) {
+    if (hi - lo <= grain) {
+        runs.leaf(lo, hi, dst);
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    pool.join([&]() { pingpong_sort(pool, runs, lo, mid, 1 - dst, grain); },
+              [&]() { pingpong_sort(pool, runs, mid, hi, 1 - dst, grain); });
+    merge_runs(pool, runs, 1 - dst, lo, mid, hi, grain);
+}
+
+// 单个数组：0 号缓冲是调用者的迭代器，1 号是 scratch 指针；叶子用 std::sort（所以整体不稳定）
+// int32/float/int64 默认升序且连续存储时，叶子改用排序网络内核（见 SortingNetwork.h），
+// 借 scratch 的同一段当临时区 —— 叶子执行时这两段都只属于它
+template<typename RandomIt, typename T, typename Compare>
+struct ArrayRuns {
+    RandomIt data;
+    T* scratch;
+    Compare* comp;
+
+    const T& key(int b, size_t i) const { return b == 0 ? data[i] : scratch[i]; }
+
+    void leaf(size_t lo, size_t hi, int dst) {
+        auto first = data + static_cast<std::ptrdiff_t>(lo), last = data + static_cast<std::ptrdiff_t>(hi);
+        bool done = false;
+        if constexpr (simd_detail::kSimdEligible<RandomIt, T, Compare>) {
+            done = simd_sort(&*first, hi - lo, scratch + lo);
+        }
+        if (!done) std::sort(first, last, *comp);
+        if (dst == 1) std::move(first, last, scratch + lo);
+    }
+
+    void merge(int from, size_t a_lo, size_t a_hi, size_t b_lo, size_t b_hi, size_t out) {
+        if (from == 0) {
+            merge_into(data, scratch, a_lo, a_hi, b_lo, b_hi, out);
+        } else {
+            merge_into(scratch, data, a_lo, a_hi, b_lo, b_hi, out);
+        }
+    }
+
+    template<typename Src, typename Dst>
+    void merge_into(Src src, Dst dst, size_t a_lo, size_t a_hi, size_t b_lo, size_t b_hi, size_t out) {
+        using D = std::ptrdiff_t;
+        std::merge(std::make_move_iterator(src + static_cast<D>(a_lo)), std::make_move_iterator(src + static_cast<D>(a_hi)),
+                   std::make_move_iterator(src + static_cast<D>(b_lo)), std::make_move_iterator(src + static_cast<D>(b_hi)),
+                   dst + static_cast<D>(out), *comp);
+    }
+};
+
+// 键和负载分开存放的两个数组，一起搬动；叶子是自底向上的归并（插入排序起步），全程稳定、不分配
+template<typename KeyIt, typename ValueIt, typename K, typename V, typename Compare>
+struct KeyValueRuns {
+    KeyIt keys;
+    ValueIt values;
+    K* key_scratch;
+    V* value_scratch;
+    Compare* comp;
+
+    static constexpr size_t kInsertionRun = 32;
+
+    const K& key(int b, size_t i) const { return b == 0 ? keys[i] : key_scratch[i]; }
+
+    void leaf(size_t lo, size_t hi, int dst) {
+        for (size_t s = lo; s < hi; s += kInsertionRun) insertion_sort(s, std::min(hi, s + kInsertionRun));
+        int cur = 0;
+        for (size_t width = kInsertionRun; width < hi - lo; width *= 2) {
+            for (size_t s = lo; s < hi; s += 2 * width) {
+                size_t mid = std::min(hi, s + width), end = std::min(hi, s + 2 * width);
+                merge(cur, s, mid, mid, end, s);
+            }
+            cur = 1 - cur;
+        }
+        if (cur != dst) {
+            if (cur == 0) {
+                move_into(keys, values, key_scratch, value_scratch, lo, hi);
+            } else {
+                move_into(key_scratch, value_scratch, keys, values, lo, hi);
+            }
+        }
+    }
+
+    void merge(int from, size_t a_lo, size_t a_hi, size_t b_lo, size_t b_hi, size_t out) {
+        if (from == 0) {
+            merge_into(keys, values, key_scratch, value_scratch, a_lo, a_hi, b_lo, b_hi, out);
+        } else {
+            merge_into(key_scratch, value_scratch, keys, values, a_lo, a_hi, b_lo, b_hi, out);
+        }
+    }
+
+    // 相等时先取前一段的（稳定）
+    template<typename SK, typename SV, typename DK, typename DV>
+    void merge_into(SK sk, SV sv, DK dk, DV dv, size_t i, size_t a_hi, size_t j, size_t b_hi, size_t out) {
+        while (i < a_hi && j < b_hi) {
+            if ((*comp)(sk[j], sk[i])) {
+                dk[out] = std::move(sk[j]);
+                dv[out++] = std::move(sv[j++]);
+            } else {
+                dk[out] = std::move(sk[i]);
+                dv[out++] = std::move(sv[i++]);
+            }
+        }
+        for (; i < a_hi; ++i, ++out) {
+            dk[out] = std::move(sk[i]);
+            dv[out] = std::move(sv[i]);
+        }
+        for (; j < b_hi; ++j, ++out) {
+            dk[out] = std::move(sk[j]);
+            dv[out] = std::move(sv[j]);
+        }
+    }
+
+    template<typename SK, typename SV, typename DK, typename DV>
+    static void move_into(SK sk, SV sv, DK dk, DV dv, size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            dk[i] = std::move(sk[i]);
+            dv[i] = std::move(sv[i]);
+        }
+    }
+
+    void insertion_sort(size_t lo, size_t hi) {
+        for (size_t i = lo + 1; i < hi; ++i) {
+            K k = std::move(keys[i]);
+            V v = std::move(values[i]);
+            size_t j = i;
+            for (; j > lo && (*comp)(k, keys[j - 1]); --j) {
+                keys[j] = std::move(keys[j - 1]);
+                values[j] = std::move(values[j - 1]);
+            }
+            keys[j] = std::move(k);
+            values[j] = std::move(v);
+        }
+    }
+};
+
+} // namespace sort_detail
+
+// =========================
+// parallel_merge(pool, first1, last1, first2, last2, d_first, comp)
+// 把两个有序区间合并到 d_first（随机访问，不能和输入重叠），稳定；返回输出的尾后迭代器
+// 不管两个输入多长、长短多悬殊，输出都按元素数均分给所有工人
+// =========================
+template<typename ItA, typename ItB, typename OutIt, typename Compare = std::less<>>
+OutIt parallel_merge(WorkStealingPool& pool, ItA first1, ItA last1, ItB first2, ItB last2, OutIt d_first,
+                     Compare comp = Compare()) {
+    auto m = static_cast<size_t>(std::distance(first1, last1));
+    auto n = static_cast<size_t>(std::distance(first2, last2));
+    size_t grain = sort_detail::auto_grain(m + n, pool.thread_count());
+    if (m + n <= grain || pool.thread_count() <= 1) return std::merge(first1, last1, first2, last2, d_first, comp);
+    pool.run([&]() {
+        sort_detail::merge_parts(pool, first1, m, first2, n, d_first, comp, grain);
+    });
+    return d_first + static_cast<std::ptrdiff_t>(m + n);
+}
+
+// =========================
+// parallel_merge_sort_buffered(pool, begin, end, scratch, comp)
+// 原地排序（不稳定：叶子用 std::sort 或排序网络内核）；外部线程调用会阻塞到排完，工人线程里调用会边等边干活
+// scratch 由调用者提供，至少 n 个元素，内容会被覆盖。数据和 scratch 逐层乒乓，
+// 每一层（包括最顶上那次 n/2 + n/2）都是一次并行合并，没有额外的搬回和分配
+// =========================
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_merge_sort_buffered(WorkStealingPool& pool, RandomIt begin, RandomIt end,
+                                  typename std::iterator_traits<RandomIt>::value_type* scratch,
+                                  Compare comp = Compare()) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    auto n = static_cast<size_t>(std::distance(begin, end));
+    if (n < 2) return; // 排序网络内核要取 &*begin，空区间不能往下走
+    size_t grain = sort_detail::auto_grain(n, pool.thread_count());
+    sort_detail::ArrayRuns<RandomIt, T, Compare> runs{begin, scratch, &comp};
+    if (n <= grain || pool.thread_count() <= 1) {
+        runs.leaf(0, n, 0);
+        return;
+    }
+    pool.run([&]() { sort_detail::pingpong_sort(pool, runs, 0, n, 0, grain); });
+}
+
+// parallel_merge_sort(pool, begin, end, comp)：同上，scratch 在这里一次性分配（见 ScratchBuffer）
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_merge_sort(WorkStealingPool& pool, RandomIt begin, RandomIt end, Compare comp = Compare()) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    auto n = static_cast<size_t>(std::distance(begin, end));
+    if (n < 2) return;
+    bool small = n <= sort_detail::auto_grain(n, pool.thread_count()) || pool.thread_count() <= 1;
+    if (small && !simd_detail::kSimdEligible<RandomIt, T, Compare>) {
+        std::sort(begin, end, comp);
+        return;
+    }
+    sort_detail::ScratchBuffer<T> scratch(pool, n, begin);
+    parallel_merge_sort_buffered(pool, begin, end, scratch.data(), comp);
+}
+
+// 用默认工作窃取池
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_merge_sort(RandomIt begin, RandomIt end, Compare comp = Compare()) {
+    parallel_merge_sort(default_work_stealing_pool(), begin, end, comp);
+}
+
+// =========================
+// parallel_sort_by_key_buffered(pool, keys_first, keys_last, values_first, key_scratch, value_scratch, comp)
+// 按键排序，负载数组跟着一起动；稳定（键相等时保持原来的相对顺序）
+// 典型用法：键是 uint32/float，负载是行号或者大结构体的下标，不用先打包成 pair 再拆开
+// 两块 scratch 各至少 n 个元素
+// =========================
+template<typename KeyIt, typename ValueIt, typename Compare = std::less<>>
+void parallel_sort_by_key_buffered(WorkStealingPool& pool, KeyIt keys_first, KeyIt keys_last, ValueIt values_first,
+                                   typename std::iterator_traits<KeyIt>::value_type* key_scratch,
+                                   typename std::iterator_traits<ValueIt>::value_type* value_scratch,
+                                   Compare comp = Compare()) {
+    using K = typename std::iterator_traits<KeyIt>::value_type;
+    using V = typename std::iterator_traits<ValueIt>::value_type;
+    auto n = static_cast<size_t>(std::distance(keys_first, keys_last));
+    size_t grain = sort_detail::auto_grain(n, pool.thread_count());
+    sort_detail::KeyValueRuns<KeyIt, ValueIt, K, V, Compare> runs{keys_first, values_first, key_scratch,
+                                                                   value_scratch, &comp};
+    if (n <= grain || pool.thread_count() <= 1) {
+        runs.leaf(0, n, 0);
+        return;
+    }
+    pool.run([&]() { sort_detail::pingpong_sort(pool, runs, 0, n, 0, grain); });
+}
+
+// 同上，scratch 在这里一次性分配（见 ScratchBuffer）
+template<typename KeyIt, typename ValueIt, typename Compare = std::less<>>
+void parallel_sort_by_key(WorkStealingPool& pool, KeyIt keys_first, KeyIt keys_last, ValueIt values_first,
+                          Compare comp = Compare()) {
+    using K = typename std::iterator_traits<KeyIt>::value_type;
+    using V = typename std::iterator_traits<ValueIt>::value_type;
+    auto n = static_cast<size_t>(std::distance(keys_first, keys_last));
+    sort_detail::ScratchBuffer<K> key_scratch(pool, n, keys_first);
+    sort_detail::ScratchBuffer<V> value_scratch(pool, n, values_first);
+    parallel_sort_by_key_buffered(pool, keys_first, keys_last, values_first, key_scratch.data(),
+                                  value_scratch.data(), comp);
+}
+
+#endif //CONCURRENCY_STUDY_PARALLELSORT_H
@@ -0,0 +1,169 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <cstdint>
+#include "ParallelSort.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::vector<int> random_ints(size_t n, uint32_t seed) {
+    std::vector<int> v(n);
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dis(1, 1000000000);
+    for (auto& x : v) x = dis(gen);
+    return v;
+}
+
+// 没有默认构造函数的元素：scratch 只能从原数据拷贝构造出来
+struct Tagged {
+    int key;
+    std::string tag;
+    explicit Tagged(int k) : key(k), tag("t" + std::to_string(k)) {}
+    bool operator<(const Tagged& o) const { return key < o.key; }
+    bool operator==(const Tagged& o) const { return key == o.key && tag == o.tag; }
+};
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    WorkStealingPool& pool = default_work_stealing_pool();
+    std::cout << "工人数: " << pool.thread_count() << std::endl;
+
+    // 1. 合并两个各 2500 万的有序段：std::merge vs parallel_merge
+    {
+        const size_t half = 25000000;
+        std::vector<int> a = random_ints(half, 1), b = random_ints(half, 2);
+        std::sort(a.begin(), a.end());
+        std::sort(b.begin(), b.end());
+        std::vector<int> out1(2 * half), out2(2 * half);
+
+        auto start = Clock::now();
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), out1.begin());
+        double seq = ms_since(start);
+
+        start = Clock::now();
+        parallel_merge(pool, a.begin(), a.end(), b.begin(), b.end(), out2.begin());
+        double par = ms_since(start);
+        std::cout << "合并 2 x 2500 万: std::merge " << seq << " ms，parallel_merge " << par << " ms ("
+                  << (out1 == out2 ? "结果一致" : "结果不一致!") << ")" << std::endl;
+    }
+
+    // 2. 稳定性：键相同的元素保持 A 在前、各自内部原顺序
+    {
+        std::vector<std::pair<int, int>> a, b, out(400000);
+        for (int i = 0; i < 200000; ++i) a.emplace_back(i / 1000, i);
+        for (int i = 0; i < 200000; ++i) b.emplace_back(i / 1000, 1000000 + i);
+        auto by_key = [](const std::pair<int, int>& x, const std::pair<int, int>& y) { return x.first < y.first; };
+        parallel_merge(pool, a.begin(), a.end(), b.begin(), b.end(), out.begin(), by_key);
+        std::vector<std::pair<int, int>> expect(400000);
+        std::merge(a.begin(), a.end(), b.begin(), b.end(), expect.begin(), by_key);
+        std::cout << "相等键的合并顺序: " << (out == expect ? "和 std::merge 一致 (稳定)" : "不一致!") << std::endl;
+    }
+
+    // 3. std::string：合并是移动出输入的，被移走的串变成空串，结果还得和 std::sort 一致
+    {
+        std::mt19937 gen(7);
+        std::vector<std::string> source(300000);
+        for (auto& s : source) s = "key_" + std::to_string(gen() % 100000) + std::string(gen() % 24, 'x');
+        std::vector<std::string> expect = source;
+        std::sort(expect.begin(), expect.end());
+
+        std::vector<std::string> data = source;
+        parallel_merge_sort(pool, data.begin(), data.end());
+        bool sort_ok = data == expect;
+
+        std::vector<std::string> a(expect.begin(), expect.begin() + 100000), b(expect.begin() + 100000, expect.end());
+        std::vector<std::string> out(expect.size());
+        parallel_merge(pool, std::make_move_iterator(a.begin()), std::make_move_iterator(a.end()),
+                       std::make_move_iterator(b.begin()), std::make_move_iterator(b.end()), out.begin());
+        std::cout << "30 万个 std::string: " << (sort_ok && out == expect ? "排序 / 移动合并结果一致" : "结果不一致!")
+                  << std::endl;
+
+        std::vector<Tagged> tagged;
+        for (int x : random_ints(300000, 11)) tagged.emplace_back(x);
+        std::vector<Tagged> tagged_expect = tagged;
+        std::sort(tagged_expect.begin(), tagged_expect.end());
+        parallel_merge_sort(pool, tagged.begin(), tagged.end());
+        std::cout << "30 万个没有默认构造的元素: " << (tagged == tagged_expect ? "结果一致" : "结果不一致!") << std::endl;
+    }
+
+    // 4. 5000 万个 int 整体排序
+    {
+        const size_t N = 50000000;
+        std::vector<int> source = random_ints(N, 42);
+
+        std::vector<int> data = source;
+        auto start = Clock::now();
+        std::sort(data.begin(), data.end());
+        double base = ms_since(start);
+        std::cout << "std::sort (单线程)  : " << base << " ms" << std::endl;
+
+        data = source;
+        start = Clock::now();
+        parallel_merge_sort(pool, data.begin(), data.end());
+        double ms = ms_since(start);
+        std::cout << "parallel_merge_sort : " << ms << " ms，加速比 " << base / ms << "x"
+                  << (std::is_sorted(data.begin(), data.end()) ? "" : " (没排好!)") << std::endl;
+
+        // 反复排序时复用同一块 scratch：一次分配都没有
+        std::vector<int> scratch(N);
+        data = source;
+        start = Clock::now();
+        parallel_merge_sort_buffered(pool, data.begin(), data.end(), scratch.data());
+        ms = ms_since(start);
+        std::cout << "  复用 scratch      : " << ms << " ms，加速比 " << base / ms << "x"
+                  << (std::is_sorted(data.begin(), data.end()) ? "" : " (没排好!)") << std::endl;
+
+        // 空区间 / 单个元素：直接返回，不碰 begin()
+        std::vector<int> empty, one{7};
+        parallel_merge_sort(pool, empty.begin(), empty.end());
+        parallel_merge_sort(pool, one.begin(), one.end());
+        std::cout << "  空区间 / 单个元素 : " << (empty.empty() && one[0] == 7 ? "正常" : "出错!") << std::endl;
+    }
+
+    // 5. 按键排序：键和行号分开放，一起排；键相等的行号保持升序（稳定）
+    {
+        const size_t N = 10000000;
+        std::vector<uint32_t> keys(N);
+        std::vector<uint32_t> rows(N);
+        std::mt19937 gen(7);
+        for (size_t i = 0; i < N; ++i) {
+            keys[i] = gen() % 100000; // 大量重复键
+            rows[i] = static_cast<uint32_t>(i);
+        }
+        std::vector<uint32_t> original = keys;
+
+        auto start = Clock::now();
+        parallel_sort_by_key(pool, keys.begin(), keys.end(), rows.begin());
+        double ms = ms_since(start);
+
+        bool ok = true;
+        for (size_t i = 0; i < N && ok; ++i) {
+            if (original[rows[i]] != keys[i]) ok = false;                                   // 负载跟着键走
+            if (i > 0 && keys[i - 1] == keys[i] && rows[i - 1] >= rows[i]) ok = false;     // 稳定
+            if (i > 0 && keys[i - 1] > keys[i]) ok = false;
+        }
+        std::cout << "sort_by_key 1000 万: " << ms << " ms (" << (ok ? "有序、负载对齐、稳定" : "出错!") << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,426 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_PIPELINE_H
+#define CONCURRENCY_STUDY_PIPELINE_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <sstream>
+#include <memory>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <exception>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+#include "SafeQueue.h"
+#include "PoolMetrics.h"
+
+// =========================
+// 流水线框架：把 parse -> transform -> aggregate -> write 这种手工接线的
+// “有界队列 + 每段几个线程” 用一个 builder 描述出来
+//
+//   auto p = PipelineBuilder<std::string>(1024)
+//       .stage("parse", 2, parse_fn)                         // In -> A
+//       .stage("transform", 4, transform_fn, StageOrder::Ordered)
+//       .sink("write", 1, write_fn);                         // 最后一段没有输出
+//   p.push(line); ...; p.close(); p.wait();
+//
+// - 段与段之间是有界的 SafeQueue：下游慢了，上游 produce 会阻塞，压力一路传回 push()
+// - 段函数返回 std::optional<U> 时，nullopt 表示丢弃这个元素（过滤）
+// - Ordered：段内多个线程并行算，但输出按输入顺序排好再交给下游
+// - 结束：close() 关闭输入队列；每段最后一个退出的线程关闭自己的输出队列，一路传到 sink
+// - 段函数抛异常：这个元素当作丢弃，流水线继续跑完，wait() 重新抛出第一个异常
+// =========================
+
+enum class StageOrder {
+    Unordered, // 谁先算完谁先走，吞吐最高
+    Ordered    // 保持本段输入的顺序
+};
+
+// 一段的统计快照
+struct StageSnapshot {
+    std::string name;
+    size_t workers = 0;
+    uint64_t items_in = 0;
+    uint64_t items_out = 0;
+    uint64_t busy_ns = 0;         // 在段函数里的时间（所有线程加起来）
+    uint64_t input_wait_ns = 0;   // 等输入的时间：大 -> 上游喂不饱它
+    uint64_t output_wait_ns = 0;  // 往下游塞不进去的时间：大 -> 下游是瓶颈
+    size_t queue_size = 0;        // 输入队列当前长度
+    size_t queue_capacity = 0;
+    double avg_occupancy = 0;     // 输入队列的平均占用率（抽样）
+
+    double utilization() const {
+        uint64_t total = busy_ns + input_wait_ns + output_wait_ns;
+        return total == 0 ? 0.0 : static_cast<double>(busy_ns) / static_cast<double>(total);
+    }
+};
+
+struct PipelineSnapshot {
+    std::vector<StageSnapshot> stages;
+
+    // 瓶颈：忙碌占比最高的那一段（它的输入队列通常也是满的）
+    size_t bottleneck() const {
+        size_t best = 0;
+        for (size_t i = 1; i < stages.size(); ++i) {
+            if (stages[i].utilization() > stages[best].utilization()) best = i;
+        }
+        return best;
+    }
+
+    std::string to_text() const {
+        std::ostringstream os;
+        size_t hot = bottleneck();
+        for (size_t i = 0; i < stages.size(); ++i) {
+            const auto& s = stages[i];
+            auto pct = [&s](uint64_t ns) {
+                uint64_t total = s.busy_ns + s.input_wait_ns + s.output_wait_ns;
+                return total == 0 ? 0 : static_cast<int>(ns * 100 / total);
+            };
+            os << "  [" << s.name << "] x" << s.workers
+               << " in=" << s.items_in << " out=" << s.items_out
+               << " busy=" << pct(s.busy_ns) << "%"
+               << " wait_in=" << pct(s.input_wait_ns) << "%"
+               << " wait_out=" << pct(s.output_wait_ns) << "%"
+               << " queue=" << s.queue_size << "/" << s.queue_capacity
+               << " avg_fill=" << static_cast<int>(s.avg_occupancy * 100) << "%"
+               << (i == hot && !stages.empty() ? "   <-- 瓶颈" : "") << "\n";
+        }
+        return os.str();
+    }
+};
+
+namespace pipeline_detail {
+
+// 队列里的元素带一个序号：Ordered 段靠它把乱序的结果排回去
+template<typename T>
+struct Item {
+    uint64_t seq = 0;
+    T value;
+};
+
+template<typename T>
+using Queue = SafeQueue<Item<T>>;
+
+// 段函数的返回值 -> 输出类型：optional<U> -> U（可过滤），void -> 没有输出（sink）
+template<typename R>
+struct output_of { using type = R; };
+
+template<typename U>
+struct output_of<std::optional<U>> { using type = U; };
+
+// 每个线程一份计数，只有自己写
+struct alignas(64) StageWorkerStats {
+    std::atomic<uint64_t> items_in{0};
+    std::atomic<uint64_t> items_out{0};
+    std::atomic<uint64_t> busy_ns{0};
+    std::atomic<uint64_t> input_wait_ns{0};
+    std::atomic<uint64_t> output_wait_ns{0};
+    std::atomic<uint64_t> occupancy_sum{0};     // 抽样时的队列长度之和
+    std::atomic<uint64_t> occupancy_samples{0};
+};
+
+// 第一个异常
+struct ErrorSlot {
+    std::mutex mtx;
+    std::exception_ptr first;
+
+    void record(std::exception_ptr e) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!first) first = std::move(e);
+    }
+};
+
+inline uint64_t elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+class StageBase {
+public:
+    StageBase(std::string name, size_t workers, std::shared_ptr<ErrorSlot> errors)
+            : name_(std::move(name)), workers_(workers == 0 ? 1 : workers),
+              stats_(workers_), errors_(std::move(errors)) {}
+
+    virtual ~StageBase() { join(); }
+
+    virtual void start() = 0;
+
+    void join() {
+        for (auto& t : threads_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    StageSnapshot snapshot() const {
+        StageSnapshot s;
+        s.name = name_;
+        s.workers = workers_;
+        uint64_t occ_sum = 0, occ_samples = 0;
+        for (const auto& w : stats_) {
+            s.items_in += w.items_in.load(std::memory_order_relaxed);
+            s.items_out += w.items_out.load(std::memory_order_relaxed);
+            s.busy_ns += w.busy_ns.load(std::memory_order_relaxed);
+            s.input_wait_ns += w.input_wait_ns.load(std::memory_order_relaxed);
+            s.output_wait_ns += w.output_wait_ns.load(std::memory_order_relaxed);
+            occ_sum += w.occupancy_sum.load(std::memory_order_relaxed);
+            occ_samples += w.occupancy_samples.load(std::memory_order_relaxed);
+        }
+        s.queue_size = input_size();
+        s.queue_capacity = input_capacity();
+        if (occ_samples > 0 && s.queue_capacity > 0) {
+            s.avg_occupancy = static_cast<double>(occ_sum) / static_cast<double>(occ_samples)
+                              / static_cast<double>(s.queue_capacity);
+        }
+        return s;
+    }
+
+protected:
+    virtual size_t input_size() const = 0;
+    virtual size_t input_capacity() const = 0;
+
+    std::string name_;
+    size_t workers_;
+    std::vector<StageWorkerStats> stats_;
+    std::shared_ptr<ErrorSlot> errors_;
+    std::vector<std::thread> threads_;
+};
+
+// 一段：从 in_ 取 In，调用 fn，结果（如果有）放进 out_
+template<typename In, typename Fn>
+class Stage : public StageBase {
+public:
+    using Result = std::invoke_result_t<Fn&, In&&>;
+    using Out = typename output_of<Result>::type;
+    static constexpr bool kSink = std::is_void_v<Out>;
+    using OutQueue = std::conditional_t<kSink, Queue<int>, Queue<Out>>; // sink 没有输出队列，占个位
+
+    Stage(std::string name, size_t workers, Fn fn, StageOrder order,
+          std::shared_ptr<Queue<In>> in, std::shared_ptr<OutQueue> out, std::shared_ptr<ErrorSlot> errors)
+            : StageBase(std::move(name), workers, std::move(errors)),
+              fn_(std::move(fn)), ordered_(order == StageOrder::Ordered && workers_ > 1),
+              in_(std::move(in)), out_(std::move(out)), live_(workers_) {}
+
+    ~Stage() override { join(); }
+
+    void start() override {
+        for (size_t i = 0; i < workers_; ++i) {
+            threads_.emplace_back([this, i]() { work(i); });
+        }
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Pending = std::conditional_t<kSink, bool, std::optional<Out>>;
+
+    size_t input_size() const override { return in_->size(); }
+    size_t input_capacity() const override { return in_->capacity(); }
+
+    void work(size_t index) {
+        StageWorkerStats& st = stats_[index];
+        Item<In> item;
+        auto t0 = Clock::now();
+        while (in_->consume(item)) {
+            auto t1 = Clock::now();
+            single_writer_add(st.input_wait_ns, elapsed_ns(t0, t1));
+            uint64_t n = st.items_in.load(std::memory_order_relaxed);
+            single_writer_add(st.items_in, 1);
+            if ((n & 63) == 0) { // 每 64 个抽样一次队列长度（size() 要加锁，不能每个都看）
+                single_writer_add(st.occupancy_sum, in_->size());
+                single_writer_add(st.occupancy_samples, 1);
+            }
+
+            Pending result = call(std::move(item.value));
+            auto t2 = Clock::now();
+            single_writer_add(st.busy_ns, elapsed_ns(t1, t2));
+
+            if constexpr (!kSink) {
+                if (ordered_) commit_ordered(item.seq, std::move(result), st);
+                else if (result) emit(std::move(*result), st);
+            }
+            t0 = Clock::now();
+            single_writer_add(st.output_wait_ns, elapsed_ns(t2, t0));
+        }
+        single_writer_add(st.input_wait_ns, elapsed_ns(t0, Clock::now()));
+
+        // 最后一个退出的线程负责把结束信号往下传
+        if (live_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            if constexpr (!kSink) out_->close();
+        }
+    }
+
+    // 调用段函数；抛异常的元素记下异常后当作丢弃
+    Pending call(In&& value) {
+        try {
+            if constexpr (kSink) {
+                fn_(std::move(value));
+                return true;
+            } else {
+                return Pending(fn_(std::move(value)));
+            }
+        } catch (...) {
+            errors_->record(std::current_exception());
+            return Pending{};
+        }
+    }
+
+    template<typename V>
+    void emit(V&& value, StageWorkerStats& st) {
+        uint64_t seq = out_seq_.fetch_add(1, std::memory_order_relaxed);
+        if (out_->produce(Item<Out>{seq, std::forward<V>(value)})) single_writer_add(st.items_out, 1);
+    }
+
+    // 乱序完成的结果先放进重排区，凑齐了连续的一段就按顺序交给下游
+    void commit_ordered(uint64_t seq, Pending result, StageWorkerStats& st) {
+        std::lock_guard<std::mutex> lock(reorder_mtx_);
+        reorder_.emplace(seq, std::move(result));
+        while (!reorder_.empty() && reorder_.begin()->first == next_in_) {
+            auto node = reorder_.extract(reorder_.begin());
+            ++next_in_;
+            if (node.mapped()) {
+                // 持锁往下游塞：下游满了，其他线程的结果也只能等着，顺序不会乱
+                if (out_->produce(Item<Out>{next_out_++, std::move(*node.mapped())})) {
+                    single_writer_add(st.items_out, 1);
+                }
+            }
+        }
+    }
+
+    Fn fn_;
+    bool ordered_;
+    std::shared_ptr<Queue<In>> in_;
+    std::shared_ptr<OutQueue> out_;
+    std::atomic<size_t> live_;
+    std::atomic<uint64_t> out_seq_{0};
+
+    std::mutex reorder_mtx_;
+    std::map<uint64_t, Pending> reorder_;
+    uint64_t next_in_ = 0;
+    uint64_t next_out_ = 0;
+};
+
+} // namespace pipeline_detail
+
+// =========================
+// 搭好的流水线：push / close / wait / stats
+// =========================
+template<typename In>
+class Pipeline {
+public:
+    Pipeline(std::shared_ptr<pipeline_detail::Queue<In>> input,
+             std::vector<std::unique_ptr<pipeline_detail::StageBase>> stages,
+             std::shared_ptr<pipeline_detail::ErrorSlot> errors)
+            : input_(std::move(input)), stages_(std::move(stages)), errors_(std::move(errors)) {
+        for (auto& s : stages_) s->start();
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // 没有显式 wait() 也要把线程收掉
+    ~Pipeline() {
+        close();
+        for (auto& s : stages_) s->join();
+    }
+
+    // 送进一个元素；队列满时阻塞（反压）。close() 之后返回 false
+    // 序号在输入队列的锁里、确定入队之后才分配：和 close() 撞上时不会留下一个永远等不到的空号，
+    // 否则 Ordered 段会一直等它，后面的元素全部卡在重排区里
+    bool push(In value) {
+        return input_->produce_with([this, &value]() {
+            return pipeline_detail::Item<In>{next_seq_++, std::move(value)};
+        });
+    }
+
+    // 输入结束：已经送进去的元素会照常流到 sink
+    void close() { input_->close(); }
+
+    // 等所有段处理完；有段函数抛过异常就重新抛出第一个
+    void wait() {
+        for (auto& s : stages_) s->join();
+        std::exception_ptr e;
+        {
+            std::lock_guard<std::mutex> lock(errors_->mtx);
+            e = errors_->first;
+        }
+        if (e) std::rethrow_exception(e);
+    }
+
+    PipelineSnapshot stats() const {
+        PipelineSnapshot snap;
+        for (const auto& s : stages_) snap.stages.push_back(s->snapshot());
+        return snap;
+    }
+
+private:
+    std::shared_ptr<pipeline_detail::Queue<In>> input_;
+    std::vector<std::unique_ptr<pipeline_detail::StageBase>> stages_;
+    std::shared_ptr<pipeline_detail::ErrorSlot> errors_;
+    uint64_t next_seq_ = 0; // 只在输入队列的锁里读写
+};
+
+// =========================
+// builder：In 是流水线的输入类型，Cur 是当前最后一段的输出类型
+// =========================
+template<typename In, typename Cur = In>
+class PipelineBuilder {
+public:
+    // queue_capacity：段与段之间每个队列的容量
+    explicit PipelineBuilder(size_t queue_capacity = 1024)
+            : capacity_(queue_capacity),
+              input_(std::make_shared<pipeline_detail::Queue<In>>(queue_capacity)),
+              errors_(std::make_shared<pipeline_detail::ErrorSlot>()) {
+        static_assert(std::is_same_v<In, Cur>, "start a pipeline with PipelineBuilder<In>");
+        tail_ = input_;
+    }
+
+    // 加一段 Cur -> Out；fn 返回 std::optional<Out> 时可以丢弃元素
+    template<typename Fn>
+    auto stage(std::string name, size_t parallelism, Fn fn, StageOrder order = StageOrder::Unordered) {
+        using StageT = pipeline_detail::Stage<Cur, Fn>;
+        using Out = typename StageT::Out;
+        static_assert(!StageT::kSink, "a stage must return a value; use sink() for the last stage");
+
+        auto out = std::make_shared<pipeline_detail::Queue<Out>>(capacity_);
+        stages_.push_back(std::make_unique<StageT>(std::move(name), parallelism, std::move(fn), order,
+                                                   tail_, out, errors_));
+        return PipelineBuilder<In, Out>(capacity_, std::move(input_), std::move(out),
+                                        std::move(stages_), std::move(errors_));
+    }
+
+    // 最后一段：fn 不返回值。启动所有线程，返回可以 push 的流水线
+    template<typename Fn>
+    Pipeline<In> sink(std::string name, size_t parallelism, Fn fn) {
+        using StageT = pipeline_detail::Stage<Cur, Fn>;
+        static_assert(StageT::kSink, "sink() function must return void");
+
+        stages_.push_back(std::make_unique<StageT>(std::move(name), parallelism, std::move(fn),
+                                                   StageOrder::Unordered, tail_, nullptr, errors_));
+        return Pipeline<In>(std::move(input_), std::move(stages_), std::move(errors_));
+    }
+
+private:
+    template<typename, typename> friend class PipelineBuilder;
+
+    PipelineBuilder(size_t capacity, std::shared_ptr<pipeline_detail::Queue<In>> input,
+                    std::shared_ptr<pipeline_detail::Queue<Cur>> tail,
+                    std::vector<std::unique_ptr<pipeline_detail::StageBase>> stages,
+                    std::shared_ptr<pipeline_detail::ErrorSlot> errors)
+            : capacity_(capacity), input_(std::move(input)), tail_(std::move(tail)),
+              stages_(std::move(stages)), errors_(std::move(errors)) {}
+
+    size_t capacity_;
+    std::shared_ptr<pipeline_detail::Queue<In>> input_;
+    std::shared_ptr<pipeline_detail::Queue<Cur>> tail_;
+    std::vector<std::unique_ptr<pipeline_detail::StageBase>> stages_;
+    std::shared_ptr<pipeline_detail::ErrorSlot> errors_;
+};
+
+#endif //CONCURRENCY_STUDY_PIPELINE_H
@@ -0,0 +1,131 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+#include "Pipeline.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+// 模拟 ingest：parse -> transform -> aggregate -> write
+// 原来每一段都要自己开线程、自己接 BoundedBuffer，这里几行搭起来
+
+struct Record {
+    uint64_t id = 0;
+    std::string user;
+    double amount = 0;
+};
+
+// 故意让 transform 比较重，看看统计能不能一眼指出它
+double heavy_score(double x) {
+    double acc = x;
+    for (int i = 0; i < 2000; ++i) acc = std::sqrt(acc * acc + 1.0);
+    return acc;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    std::unordered_map<std::string, double> totals; // 只有 write 段（单线程）访问
+    std::atomic<uint64_t> last_id{0};
+    std::atomic<bool> in_order{true};
+
+    auto pipeline = PipelineBuilder<std::string>(256)
+        .stage("parse", 1, [](std::string line) -> Record {
+            // 格式：id,user,amount
+            size_t a = line.find(','), b = line.rfind(',');
+            return Record{std::stoull(line.substr(0, a)), line.substr(a + 1, b - a - 1),
+                          std::stod(line.substr(b + 1))};
+        })
+        .stage("transform", 4, [](Record r) {
+            r.amount = heavy_score(r.amount);
+            return r;
+        }, StageOrder::Ordered)
+        .stage("aggregate", 1, [](Record r) -> std::optional<Record> {
+            if (r.user == "bot") return std::nullopt; // 过滤掉机器流量
+            return r;
+        })
+        .sink("write", 1, [&](Record r) {
+            // transform 是 Ordered 的，这里看到的 id 应该严格递增
+            if (r.id < last_id.load(std::memory_order_relaxed)) in_order.store(false);
+            last_id.store(r.id, std::memory_order_relaxed);
+            totals[r.user] += r.amount;
+        });
+
+    const uint64_t N = 200000;
+    const char* users[] = {"alice", "bob", "carol", "bot"};
+
+    // 跑到一半时打印一次统计
+    std::thread monitor([&pipeline]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        std::cout << "运行中:\n" << pipeline.stats().to_text();
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < N; ++i) {
+        pipeline.push(std::to_string(i) + "," + users[i % 4] + "," + std::to_string(i % 100));
+    }
+    pipeline.close();
+    pipeline.wait();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    monitor.join();
+
+    std::cout << "结束:\n" << pipeline.stats().to_text();
+    std::cout << N << " 条记录，耗时 " << ms << " ms；用户数 " << totals.size()
+              << "，顺序 " << (in_order.load() ? "正确" : "错乱") << std::endl;
+
+    // 段函数抛异常：流水线照样跑完，wait() 把异常抛出来
+    auto failing = PipelineBuilder<int>(16)
+        .stage("check", 2, [](int x) {
+            if (x == 42) throw std::runtime_error("bad record 42");
+            return x;
+        })
+        .sink("drop", 1, [](int) {});
+    for (int i = 0; i < 100; ++i) failing.push(i);
+    failing.close();
+    try {
+        failing.wait();
+    } catch (const std::exception& e) {
+        std::cout << "捕获异常: " << e.what() << "，check 段输出 "
+                  << failing.stats().stages[0].items_out << " 条" << std::endl;
+    }
+
+    // 边 push 边 close：push 返回 true 的元素都要流到 sink，Ordered 段不能卡在空号上
+    {
+        const int rounds = 50;
+        int lost = 0;
+        for (int r = 0; r < rounds; ++r) {
+            std::atomic<long long> accepted{0}, arrived{0};
+            auto racing = PipelineBuilder<int>(8)
+                .stage("id", 4, [](int x) { return x; }, StageOrder::Ordered)
+                .sink("count", 1, [&arrived](int) { ++arrived; });
+            std::vector<std::thread> pushers;
+            for (int t = 0; t < 3; ++t) {
+                pushers.emplace_back([&racing, &accepted]() {
+                    while (racing.push(1)) ++accepted;
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            racing.close();
+            for (auto& t : pushers) t.join();
+            racing.wait();
+            if (accepted.load() != arrived.load()) ++lost;
+        }
+        std::cout << "边 push 边 close " << rounds << " 轮: " << (lost == 0 ? "接受的元素全部到达" : "有元素丢失!") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_POOLMETRICS_H
+#define CONCURRENCY_STUDY_POOLMETRICS_H
+
+#include <atomic>
+#include <array>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdint>
+
+// =========================
+// 线程池埋点：每个工人一份统计，只有工人自己写，别人只读
+// 所以写的时候不用 fetch_add（带 lock 前缀的 RMW），load + store 就够了
+// =========================
+
+// 直方图按 2 的幂分桶：第 i 个桶装 [2^(i-1), 2^i) 纳秒，桶 0 装 0ns
+constexpr size_t kHistogramBuckets = 48; // 2^47 ns ≈ 39 小时，足够了
+
+inline size_t histogram_bucket(uint64_t ns) {
+    if (ns == 0) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+    size_t bucket = 64 - static_cast<size_t>(__builtin_clzll(ns));
+#else
+    size_t bucket = 0;
+    while (ns) { ns >>= 1; ++bucket; }
+#endif
+    return bucket < kHistogramBuckets ? bucket : kHistogramBuckets - 1;
+}
+
+// 单写者计数器：只有一个线程会改它
+inline void single_writer_add(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// 每个工人独占一个缓存行起步，避免工人之间伪共享
+struct alignas(64) WorkerStats {
+    std::atomic<uint64_t> tasks{0};
+    std::atomic<uint64_t> busy_ns{0};
+    std::atomic<uint64_t> idle_ns{0};
+    std::atomic<uint64_t> handoffs{0}; // 从溢出队列回填到主队列的任务数
+    std::atomic<bool> alive{true};
+
+    std::array<std::atomic<uint64_t>, kHistogramBuckets> wait_hist{}; // 入队 -> 开始执行
+    std::array<std::atomic<uint64_t>, kHistogramBuckets> run_hist{};  // 执行耗时
+
+    // 每个任务调一次：两次桶计数 + 三个累加，全是 relaxed 的普通读写
+    void record(uint64_t wait_ns, uint64_t run_ns, uint64_t idle_before_ns) {
+        single_writer_add(tasks, 1);
+        single_writer_add(busy_ns, run_ns);
+        single_writer_add(idle_ns, idle_before_ns);
+        single_writer_add(wait_hist[histogram_bucket(wait_ns)], 1);
+        single_writer_add(run_hist[histogram_bucket(run_ns)], 1);
+    }
+
+    // 把另一个工人的计数并进来（工人退休时并进线程池的“已退休”汇总）。
+    // 同一时刻只能有一个线程调用，线程池在自己的锁里调
+    void absorb(const WorkerStats& other) {
+        single_writer_add(tasks, other.tasks.load(std::memory_order_relaxed));
+        single_writer_add(busy_ns, other.busy_ns.load(std::memory_order_relaxed));
+        single_writer_add(idle_ns, other.idle_ns.load(std::memory_order_relaxed));
+        single_writer_add(handoffs, other.handoffs.load(std::memory_order_relaxed));
+        for (size_t i = 0; i < kHistogramBuckets; ++i) {
+            single_writer_add(wait_hist[i], other.wait_hist[i].load(std::memory_order_relaxed));
+            single_writer_add(run_hist[i], other.run_hist[i].load(std::memory_order_relaxed));
+        }
+    }
+};
+
+// 快照：普通值，可以随便拷贝、比较、打印
+struct WorkerSnapshot {
+    size_t index = 0;
+    bool alive = false;
+    uint64_t tasks = 0;
+    uint64_t busy_ns = 0;
+    uint64_t idle_ns = 0;
+    uint64_t handoffs = 0;
+    std::array<uint64_t, kHistogramBuckets> wait_hist{};
+    std::array<uint64_t, kHistogramBuckets> run_hist{};
+
+    // 忙碌占比：busy / (busy + idle)
+    double utilization() const {
+        uint64_t total = busy_ns + idle_ns;
+        return total == 0 ? 0.0 : static_cast<double>(busy_ns) / static_cast<double>(total);
+    }
+};
+
+// 从直方图估算分位数：返回所在桶的上界（纳秒），精度是 2 倍以内
+inline uint64_t histogram_percentile(const std::array<uint64_t, kHistogramBuckets>& hist, double p) {
+    uint64_t total = 0;
+    for (uint64_t c : hist) total += c;
+    if (total == 0) return 0;
+
+    uint64_t target = static_cast<uint64_t>(p * static_cast<double>(total));
+    if (target >= total) target = total - 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kHistogramBuckets; ++i) {
+        seen += hist[i];
+        if (seen > target) return i == 0 ? 0 : (uint64_t{1} << i);
+    }
+    return uint64_t{1} << (kHistogramBuckets - 1);
+}
+
+struct PoolMetricsSnapshot {
+    std::vector<WorkerSnapshot> workers; // 还没退休的工人
+    WorkerSnapshot retired;              // 所有已退休工人的汇总（弹性池反复扩缩容，快照也不会越来越大）
+    size_t retired_workers = 0;
+    size_t queue_size = 0;
+    size_t live_threads = 0;
+
+    WorkerSnapshot total() const {
+        WorkerSnapshot sum;
+        auto add = [&sum](const WorkerSnapshot& w) {
+            sum.tasks += w.tasks;
+            sum.busy_ns += w.busy_ns;
+            sum.idle_ns += w.idle_ns;
+            sum.handoffs += w.handoffs;
+            for (size_t i = 0; i < kHistogramBuckets; ++i) {
+                sum.wait_hist[i] += w.wait_hist[i];
+                sum.run_hist[i] += w.run_hist[i];
+            }
+        };
+        for (const auto& w : workers) add(w);
+        add(retired);
+        return sum;
+    }
+
+    std::string to_text() const {
+        std::ostringstream os;
+        WorkerSnapshot t = total();
+        os << "threads=" << live_threads << " queue=" << queue_size
+           << " tasks=" << t.tasks << " handoffs=" << t.handoffs
+           << " util=" << t.utilization() * 100 << "%"
+           << " wait_p50/p99=" << histogram_percentile(t.wait_hist, 0.5) << "/"
+           << histogram_percentile(t.wait_hist, 0.99) << "ns"
+           << " run_p50/p99=" << histogram_percentile(t.run_hist, 0.5) << "/"
+           << histogram_percentile(t.run_hist, 0.99) << "ns\n";
+        for (const auto& w : workers) {
+            os << "  worker#" << w.index << (w.alive ? "" : " (retired)")
+               << " tasks=" << w.tasks
+               << " busy=" << w.busy_ns / 1000000 << "ms"
+               << " idle=" << w.idle_ns / 1000000 << "ms"
+               << " util=" << w.utilization() * 100 << "%"
+               << " wait_p99=" << histogram_percentile(w.wait_hist, 0.99) << "ns"
+               << " run_p99=" << histogram_percentile(w.run_hist, 0.99) << "ns\n";
+        }
+        if (retired_workers > 0) {
+            os << "  retired x" << retired_workers
+               << " tasks=" << retired.tasks
+               << " busy=" << retired.busy_ns / 1000000 << "ms"
+               << " idle=" << retired.idle_ns / 1000000 << "ms"
+               << " util=" << retired.utilization() * 100 << "%\n";
+        }
+        return os.str();
+    }
+
+    std::string to_json() const {
+        std::ostringstream os;
+        auto hist_json = [&os](const std::array<uint64_t, kHistogramBuckets>& h) {
+            os << "[";
+            for (size_t i = 0; i < kHistogramBuckets; ++i) os << (i ? "," : "") << h[i];
+            os << "]";
+        };
+        os << "{\"threads\":" << live_threads << ",\"queue\":" << queue_size << ",\"workers\":[";
+        for (size_t k = 0; k < workers.size(); ++k) {
+            const auto& w = workers[k];
+            os << (k ? "," : "") << "{\"index\":" << w.index
+               << ",\"alive\":" << (w.alive ? "true" : "false")
+               << ",\"tasks\":" << w.tasks << ",\"busy_ns\":" << w.busy_ns
+               << ",\"idle_ns\":" << w.idle_ns << ",\"handoffs\":" << w.handoffs
+               << ",\"wait_hist\":";
+            hist_json(w.wait_hist);
+            os << ",\"run_hist\":";
+            hist_json(w.run_hist);
+            os << "}";
+        }
+        os << "],\"retired_workers\":" << retired_workers
+           << ",\"retired\":{\"tasks\":" << retired.tasks << ",\"busy_ns\":" << retired.busy_ns
+           << ",\"idle_ns\":" << retired.idle_ns << ",\"handoffs\":" << retired.handoffs
+           << ",\"wait_hist\":";
+        hist_json(retired.wait_hist);
+        os << ",\"run_hist\":";
+        hist_json(retired.run_hist);
+        os << "}}";
+        return os.str();
+    }
+};
+
+inline WorkerSnapshot snapshot_of(const WorkerStats& s, size_t index) {
+    WorkerSnapshot w;
+    w.index = index;
+    w.alive = s.alive.load(std::memory_order_relaxed);
+    w.tasks = s.tasks.load(std::memory_order_relaxed);
+    w.busy_ns = s.busy_ns.load(std::memory_order_relaxed);
+    w.idle_ns = s.idle_ns.load(std::memory_order_relaxed);
+    w.handoffs = s.handoffs.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kHistogramBuckets; ++i) {
+        w.wait_hist[i] = s.wait_hist[i].load(std::memory_order_relaxed);
+        w.run_hist[i] = s.run_hist[i].load(std::memory_order_relaxed);
+    }
+    return w;
+}
+
+#endif //CONCURRENCY_STUDY_POOLMETRICS_H
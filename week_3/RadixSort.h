@@ -0,0 +1,215 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_RADIXSORT_H
+#define CONCURRENCY_STUDY_RADIXSORT_H
+
+#include <vector>
+#include <memory>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+
+#include "ParallelSort.h"
+
+// =========================
+// 并行 LSD 基数排序：32/64 位整数和浮点数
+// 比较排序每个元素要 log n 次比较和难以预测的分支；基数排序每一趟只是“按 8 位数字分桶”，
+// 4 字节键最多 4 趟，每趟读两遍、写一遍，全是顺序访问
+//   1. 预扫描一遍，一次算出所有数字位的直方图；某一位上所有元素都落在同一个桶里就整趟跳过
+//      （比如值域只有 0~65535 的 int，高两个字节全一样，只需要 2 趟）
+//   2. 每趟：数据切成若干块，每块自己数直方图（不共享计数器）→ 串行前缀和得到每块每桶的写入起点
+//      → 各块并行散射。块内顺序保持、块按编号排布，所以每趟是稳定的，LSD 才成立
+//   3. 散射先写进每桶 64 字节的小缓冲（写合并），满一条缓存行再整行拷到目的地，
+//      256 个桶同时写的时候不会每个元素都弄脏一条不同的缓存行
+// 有符号数和浮点数先变换成“按无符号比较等价”的位模式，数字从变换后的位上取，元素本身不改
+// =========================
+
+namespace radix_detail {
+
+// 把键映射成同宽的无符号整数，使无符号大小顺序 == 原来的大小顺序
+template<typename T, typename Enable = void>
+struct KeyBits;
+
+template<typename T>
+struct KeyBits<T, std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>>> {
+    using U = T;
+    static U to_bits(T x) { return x; }
+};
+
+// 有符号：翻转符号位，负数就排到正数前面了
+template<typename T>
+struct KeyBits<T, std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>>> {
+    using U = std::make_unsigned_t<T>;
+    static U to_bits(T x) { return static_cast<U>(x) ^ (U(1) << (sizeof(T) * 8 - 1)); }
+};
+
+// IEEE 浮点：正数翻转符号位；负数整个取反（负得越多，位模式越大，取反后越小）
+// -0.0 排在 +0.0 前面，NaN 按位模式排到两端
+template<typename T>
+struct KeyBits<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "只支持 float / double");
+    using U = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    static U to_bits(T x) {
+        U u;
+        std::memcpy(&u, &x, sizeof(u));
+        U sign = U(1) << (sizeof(U) * 8 - 1);
+        return (u & sign) ? ~u : (u | sign);
+    }
+};
+
+constexpr size_t kRadixBits = 8;
+constexpr size_t kBuckets = size_t(1) << kRadixBits;
+constexpr size_t kLineBytes = 64;
+
+template<typename T>
+inline size_t digit(T x, size_t pass) {
+    return static_cast<size_t>((KeyBits<T>::to_bits(x) >> (pass * kRadixBits)) & (kBuckets - 1));
+}
+
+using Histogram = std::array<size_t, kBuckets>;
+
+// 一块数据在一趟里的散射：写合并缓冲攒满一条缓存行再整行写出
+template<typename T>
+void scatter_block(const T* src, size_t lo, size_t hi, T* dst, size_t pass, Histogram offsets, T* wc) {
+    constexpr size_t kPerLine = kLineBytes / sizeof(T) > 0 ? kLineBytes / sizeof(T) : 1;
+    std::array<uint32_t, kBuckets> fill{}; // 不用 uint8_t：char 类型会和所有写操作别名，逼编译器反复重读
+    for (size_t i = lo; i < hi; ++i) {
+        size_t d = digit(src[i], pass);
+        T* line = wc + d * kPerLine;
+        line[fill[d]++] = src[i];
+        if (fill[d] == kPerLine) {
+            std::memcpy(dst + offsets[d], line, sizeof(T) * kPerLine);
+            offsets[d] += kPerLine;
+            fill[d] = 0;
+        }
+    }
+    for (size_t d = 0; d < kBuckets; ++d) {
+        if (fill[d] != 0) std::memcpy(dst + offsets[d], wc + d * kPerLine, sizeof(T) * fill[d]);
+    }
+}
+
+template<typename T>
+void radix_sort(WorkStealingPool& pool, T* data, size_t n, T* scratch) {
+    constexpr size_t kPasses = sizeof(T);
+    constexpr size_t kPerLine = kLineBytes / sizeof(T) > 0 ? kLineBytes / sizeof(T) : 1;
+
+    // 块数：每个工人两块，块不小于 16K 个元素（太小的块光数直方图就不划算了）
+    size_t blocks = std::max<size_t>(1, std::min(pool.thread_count() * 2, n / 16384));
+    auto block_lo = [&](size_t b) { return n * b / blocks; };
+
+    // 每块每趟一份直方图；预扫描一次填满所有趟的
+    std::vector<std::array<Histogram, kPasses>> first_hist(blocks);
+    std::vector<Histogram> hist(blocks);
+    std::vector<T> wc(blocks * kBuckets * kPerLine); // 每块一组写合并缓冲，一次分配
+
+    auto count_all = [&](size_t b) {
+        auto& h = first_hist[b];
+        for (auto& p : h) p.fill(0);
+        for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) {
+            auto bits = KeyBits<T>::to_bits(data[i]);
+            for (size_t p = 0; p < kPasses; ++p) ++h[p][(bits >> (p * kRadixBits)) & (kBuckets - 1)];
+        }
+    };
+    sort_detail::fork_each(pool, 0, blocks, count_all);
+
+    // 这一位上所有元素同一个桶：这一趟什么都不会变，跳过
+    std::vector<size_t> passes;
+    for (size_t p = 0; p < kPasses; ++p) {
+        Histogram total{};
+        for (size_t b = 0; b < blocks; ++b) {
+            for (size_t d = 0; d < kBuckets; ++d) total[d] += first_hist[b][p][d];
+        }
+        if (std::find(total.begin(), total.end(), n) == total.end()) passes.push_back(p);
+    }
+
+    T* src = data;
+    T* dst = scratch;
+    for (size_t k = 0; k < passes.size(); ++k) {
+        size_t pass = passes[k];
+        if (k == 0) {
+            for (size_t b = 0; b < blocks; ++b) hist[b] = first_hist[b][pass]; // 数据还没动过，预扫描的就能用
+        } else {
+            auto count = [&](size_t b) {
+                hist[b].fill(0);
+                for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) ++hist[b][digit(src[i], pass)];
+            };
+            sort_detail::fork_each(pool, 0, blocks, count);
+        }
+
+        // 前缀和：桶 d 在块 b 的写入起点 = 所有更小的桶的总数 + 前面的块在桶 d 里的数量
+        size_t running = 0;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            for (size_t b = 0; b < blocks; ++b) {
+                size_t c = hist[b][d];
+                hist[b][d] = running;
+                running += c;
+            }
+        }
+
+        auto scatter = [&](size_t b) {
+            scatter_block(src, block_lo(b), block_lo(b + 1), dst, pass, hist[b], wc.data() + b * kBuckets * kPerLine);
+        };
+        sort_detail::fork_each(pool, 0, blocks, scatter);
+        std::swap(src, dst);
+    }
+
+    // 跑了奇数趟：结果在 scratch 里，并行拷回
+    if (src != data) {
+        auto copy_back = [&](size_t b) {
+            std::memcpy(data + block_lo(b), src + block_lo(b), sizeof(T) * (block_lo(b + 1) - block_lo(b)));
+        };
+        sort_detail::fork_each(pool, 0, blocks, copy_back);
+    }
+}
+
+} // namespace radix_detail
+
+// =========================
+// parallel_radix_sort(pool, begin, end)
+// 升序原地排序 8/16/32/64 位整数、float、double
+// 额外占用 n 个元素的 scratch。很短的输入直接交给 std::sort
+// 迭代器不是连续存储（比如 std::deque）时，先并行拷进一块连续缓冲，排好再并行拷回（再多占 n 个元素）
+// =========================
+template<typename RandomIt>
+void parallel_radix_sort(WorkStealingPool& pool, RandomIt begin, RandomIt end) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    static_assert(std::is_arithmetic_v<T> && !std::is_same_v<T, bool>, "parallel_radix_sort 只支持整数和浮点键");
+    auto n = static_cast<size_t>(std::distance(begin, end));
+    if (n < 4096) {
+        std::sort(begin, end);
+        return;
+    }
+    std::unique_ptr<T[]> scratch(new T[n]); // 不清零：第一次写入发生在各工人的散射里，缺页也是并行的
+    if constexpr (simd_detail::kContiguous<RandomIt, T>) {
+        T* data = &*begin;
+        pool.run([&]() { radix_detail::radix_sort(pool, data, n, scratch.get()); });
+    } else {
+        std::unique_ptr<T[]> data(new T[n]);
+        size_t blocks = std::max<size_t>(1, std::min(pool.thread_count() * 2, n / 16384));
+        auto block_lo = [&](size_t b) { return static_cast<std::ptrdiff_t>(n * b / blocks); };
+        pool.run([&]() {
+            auto copy_in = [&](size_t b) {
+                std::copy(begin + block_lo(b), begin + block_lo(b + 1), data.get() + block_lo(b));
+            };
+            sort_detail::fork_each(pool, 0, blocks, copy_in);
+            radix_detail::radix_sort(pool, data.get(), n, scratch.get());
+            auto copy_out = [&](size_t b) {
+                std::copy(data.get() + block_lo(b), data.get() + block_lo(b + 1), begin + block_lo(b));
+            };
+            sort_detail::fork_each(pool, 0, blocks, copy_out);
+        });
+    }
+}
+
+// 用默认工作窃取池
+template<typename RandomIt>
+void parallel_radix_sort(RandomIt begin, RandomIt end) {
+    parallel_radix_sort(default_work_stealing_pool(), begin, end);
+}
+
+#endif //CONCURRENCY_STUDY_RADIXSORT_H
@@ -0,0 +1,97 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "RadixSort.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 同一份数据分别用 std::sort / parallel_merge_sort / parallel_radix_sort 排，比较耗时和结果
+template<typename T>
+void compare(const std::string& name, const std::vector<T>& source, WorkStealingPool& pool) {
+    std::vector<T> expect = source;
+    auto start = Clock::now();
+    std::sort(expect.begin(), expect.end());
+    double base = ms_since(start);
+
+    std::vector<T> data = source;
+    start = Clock::now();
+    parallel_merge_sort(pool, data.begin(), data.end());
+    double merge = ms_since(start);
+
+    data = source;
+    start = Clock::now();
+    parallel_radix_sort(pool, data.begin(), data.end());
+    double radix = ms_since(start);
+
+    std::cout << name << ": std::sort " << base << " ms，归并 " << merge << " ms，基数 " << radix << " ms ("
+              << base / radix << "x)" << (data == expect ? "" : " 结果不一致!") << std::endl;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    WorkStealingPool& pool = default_work_stealing_pool();
+    std::cout << "工人数: " << pool.thread_count() << std::endl;
+    std::mt19937_64 gen(42);
+
+    // 1. TurboSort 的原始场景：5000 万个 [1, 1e9] 的随机 int
+    {
+        std::vector<int> v(50000000);
+        std::uniform_int_distribution<int> dis(1, 1000000000);
+        for (auto& x : v) x = dis(gen);
+        compare("5000 万 int        ", v, pool);
+    }
+
+    // 2. 有正有负的 int64 和 double
+    {
+        std::vector<int64_t> v(10000000);
+        for (auto& x : v) x = static_cast<int64_t>(gen());
+        compare("1000 万 int64      ", v, pool);
+    }
+    {
+        std::vector<double> v(10000000);
+        std::normal_distribution<double> dis(0.0, 1e6);
+        for (auto& x : v) x = dis(gen);
+        compare("1000 万 double     ", v, pool);
+    }
+
+    // 3. 值域很窄：高位字节全一样，那几趟直接跳过
+    {
+        std::vector<uint32_t> v(50000000);
+        for (auto& x : v) x = static_cast<uint32_t>(gen() % 65536);
+        compare("5000 万 uint32<2^16", v, pool);
+    }
+
+    // 4. 不是连续存储的 std::deque：先拷进连续缓冲再排
+    {
+        std::deque<int> d(1000000);
+        for (auto& x : d) x = static_cast<int>(gen() % 2000000000) - 1000000000;
+        std::vector<int> expect(d.begin(), d.end());
+        std::sort(expect.begin(), expect.end());
+        parallel_radix_sort(pool, d.begin(), d.end());
+        std::cout << "100 万 int 的 deque: " << (std::equal(d.begin(), d.end(), expect.begin()) ? "结果一致" : "结果不一致!")
+                  << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,353 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_SAFEQUEUE_H
+#define CONCURRENCY_STUDY_SAFEQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+#include "SegmentedQueue.h"
+
+// 队列操作结果：比单纯的 bool 多带一点信息（超时 / 已关闭）
+enum class QueueStatus {
+    Ok = 0,
+    Timeout = 1,
+    Closed = 2,
+    Full = 3
+};
+
+// 队列的底层实现，作为 SafeQueue 的第二个模板参数
+struct BoundedLocked {};      // 默认：std::queue + 一把锁，有界
+struct UnboundedLockFree {};  // SegmentedQueue：无界，入队无锁
+
+// =========================
+// 线程安全有界队列：支持 close()
+// 从 week_2/day3_task.cpp 中抽出来，供 ThreadPool 复用
+// =========================
+template<typename T, typename Backend = BoundedLocked>
+class SafeQueue {
+private:
+    std::deque<T> queue_;
+    mutable std::mutex mtx_;
+    std::condition_variable cv_not_full;
+    std::condition_variable cv_not_empty;
+
+    size_t max_size;
+    bool closed_ = false; // 队列是否关闭
+
+public:
+    explicit SafeQueue(size_t size) : max_size(size) {}
+
+    // 关闭队列：唤醒所有等待线程，让它们有机会退出
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closed_ = true;
+        cv_not_empty.notify_all();
+        cv_not_full.notify_all();
+    }
+
+    // 生产数据：如果队列已关闭，直接返回 false 表示失败
+    bool produce(T value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        // 等待：队列未满 或 队列已关闭
+        cv_not_full.wait(lock, [this]() {
+            return closed_ || queue_.size() < max_size;
+        });
+
+        if (closed_) return false; // 关闭后不再接受新任务
+
+        queue_.push_back(std::move(value));
+        lock.unlock();
+
+        cv_not_empty.notify_one();
+        return true;
+    }
+
+    // 同 produce，但元素在确定能入队之后、持锁时才由 make() 造出来：
+    // 元素里要带“入队顺序”（比如序号）时用它，被 close() 拒绝的不会占掉一个号
+    template<typename Make>
+    bool produce_with(Make&& make) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_not_full.wait(lock, [this]() {
+            return closed_ || queue_.size() < max_size;
+        });
+        if (closed_) return false;
+
+        queue_.push_back(make());
+        lock.unlock();
+
+        cv_not_empty.notify_one();
+        return true;
+    }
+
+    // 非阻塞生产：队列满了立刻返回 Full
+    // 注意参数是引用：只有成功时才会把 value 移走，失败时调用者还能拿着它做别的处理
+    QueueStatus try_produce(T& value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (closed_) return QueueStatus::Closed;
+        if (queue_.size() >= max_size) return QueueStatus::Full;
+
+        queue_.push_back(std::move(value));
+        lock.unlock();
+
+        cv_not_empty.notify_one();
+        return QueueStatus::Ok;
+    }
+
+    // 限时生产：最多等 timeout，还是满的就返回 Timeout（同样只在成功时移走 value）
+    template<typename Rep, typename Period>
+    QueueStatus produce_for(T& value, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        bool ready = cv_not_full.wait_for(lock, timeout, [this]() {
+            return closed_ || queue_.size() < max_size;
+        });
+
+        if (closed_) return QueueStatus::Closed;
+        if (!ready) return QueueStatus::Timeout;
+
+        queue_.push_back(std::move(value));
+        lock.unlock();
+
+        cv_not_empty.notify_one();
+        return QueueStatus::Ok;
+    }
+
+    // 挤掉最老的：队列满时丢弃队头，再把新数据放进去（永不阻塞）
+    // dropped 返回是否真的丢了一个
+    QueueStatus produce_drop_oldest(T value, bool& dropped) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        dropped = false;
+        if (closed_) return QueueStatus::Closed;
+
+        if (queue_.size() >= max_size && !queue_.empty()) {
+            queue_.pop_front();
+            dropped = true;
+        }
+        queue_.push_back(std::move(value));
+        lock.unlock();
+
+        cv_not_empty.notify_one();
+        return QueueStatus::Ok;
+    }
+
+    // 同上，但 pinned(x) 为真的元素不能丢：满了就丢最老的那个“可丢”的元素。
+    // 队列里全是不能丢的，返回 Full 且不移走 value
+    template<typename Pinned>
+    QueueStatus produce_drop_oldest(T& value, bool& dropped, Pinned pinned) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        dropped = false;
+        if (closed_) return QueueStatus::Closed;
+
+        if (queue_.size() >= max_size) {
+            auto victim = std::find_if_not(queue_.begin(), queue_.end(), pinned);
+            if (victim == queue_.end()) return QueueStatus::Full;
+            queue_.erase(victim);
+            dropped = true;
+        }
+        queue_.push_back(std::move(value));
+        lock.unlock();
+
+        cv_not_empty.notify_one();
+        return QueueStatus::Ok;
+    }
+
+    // 消费数据：阻塞等待
+    // 返回值：true 表示拿到数据；false 表示队列关闭且已空 -> 该退出了
+    bool consume(T& value) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        // 等待：队列非空 或 队列关闭
+        cv_not_empty.wait(lock, [this]() {
+            return closed_ || !queue_.empty();
+        });
+
+        // 如果队列关闭且没有数据了 -> 告诉调用者退出
+        if (queue_.empty()) {
+            return false;
+        }
+
+        value = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        cv_not_full.notify_one();
+        return true;
+    }
+
+    // 带超时的消费：弹性线程池靠它判断“工人闲了多久”
+    template<typename Rep, typename Period>
+    QueueStatus consume_for(T& value, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mtx_);
+
+        bool ready = cv_not_empty.wait_for(lock, timeout, [this]() {
+            return closed_ || !queue_.empty();
+        });
+
+        if (!ready) return QueueStatus::Timeout;
+        if (queue_.empty()) return QueueStatus::Closed; // 关闭且已空
+
+        value = std::move(queue_.front());
+        queue_.pop_front();
+
+        lock.unlock();
+        cv_not_full.notify_one();
+        return QueueStatus::Ok;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return queue_.size();
+    }
+
+    size_t capacity() const { return max_size; }
+
+    bool is_closed() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return closed_;
+    }
+};
+
+// =========================
+// SafeQueue<T, UnboundedLockFree>：接口和有界版一样，底层换成无界的 SegmentedQueue
+// 用在“有界就可能死锁”的地方（比如任务在执行中还要往同一个队列里投任务）
+// - 入队永远不会满，也不加锁；produce 只会因为 close() 失败
+// - close() 和入队不在同一把锁下，所以入队方先登记自己“正在入队”：消费者看到关闭后，
+//   要等登记的入队方都走完、再确认一次队列是空的，才返回 Closed，关闭前已经接受的元素不会丢
+// - 出队先自旋一会儿，真空了才睡在条件变量上；入队方只有在有人睡着时才去拿锁叫醒
+// =========================
+template<typename T>
+class SafeQueue<T, UnboundedLockFree> {
+private:
+    SegmentedQueue<T> queue_;
+    std::atomic<bool> closed_{false};
+    std::atomic<size_t> sleepers_{0};
+    std::atomic<size_t> producers_{0}; // 正在入队（已经检查过 closed_，还没入完）的生产者数
+    std::mutex mtx_;                 // 只给睡觉/叫醒用
+    std::condition_variable cv_not_empty;
+
+public:
+    // 容量参数只是为了和有界版同一个写法，这里忽略
+    explicit SafeQueue(size_t = 0) {}
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        closed_.store(true, std::memory_order_seq_cst);
+        cv_not_empty.notify_all();
+    }
+
+    bool produce(T value) {
+        return try_produce(value) == QueueStatus::Ok;
+    }
+
+    // 先登记再看 closed_（都是 seq_cst）：和 drained() 里“先看 closed_ 再看 producers_”配对，
+    // 要么这边看到已关闭直接拒绝，要么那边看到有人在入队会等它入完
+    QueueStatus try_produce(T& value) {
+        producers_.fetch_add(1, std::memory_order_seq_cst);
+        if (closed_.load(std::memory_order_seq_cst)) {
+            producers_.fetch_sub(1, std::memory_order_release);
+            return QueueStatus::Closed;
+        }
+        queue_.enqueue(std::move(value));
+        producers_.fetch_sub(1, std::memory_order_release);
+        wake_one();
+        return QueueStatus::Ok;
+    }
+
+    // 无界：永远不用等
+    template<typename Rep, typename Period>
+    QueueStatus produce_for(T& value, const std::chrono::duration<Rep, Period>&) {
+        return try_produce(value);
+    }
+
+    // 无界：永远不会挤掉旧元素
+    QueueStatus produce_drop_oldest(T value, bool& dropped) {
+        dropped = false;
+        return produce(std::move(value)) ? QueueStatus::Ok : QueueStatus::Closed;
+    }
+
+    bool consume(T& value) {
+        return wait_and_take(value, nullptr) == QueueStatus::Ok;
+    }
+
+    template<typename Rep, typename Period>
+    QueueStatus consume_for(T& value, const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        return wait_and_take(value, &deadline);
+    }
+
+    // 近似值
+    size_t size() const { return queue_.size_approx(); }
+
+    size_t capacity() const { return std::numeric_limits<size_t>::max(); }
+
+    bool is_closed() const { return closed_.load(std::memory_order_acquire); }
+
+    size_t segments_allocated() const { return queue_.segments_allocated(); }
+
+private:
+    // 入队方：先入队，再看有没有人睡着（和 wait_and_take 里“先登记，再检查一遍”配对）
+    void wake_one() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            cv_not_empty.notify_one();
+        }
+    }
+
+    // 已关闭，且没有入队到一半的生产者：之后再也不会有新元素
+    bool drained() const {
+        return closed_.load(std::memory_order_seq_cst) && producers_.load(std::memory_order_seq_cst) == 0;
+    }
+
+    QueueStatus wait_and_take(T& value, const std::chrono::steady_clock::time_point* deadline) {
+        for (int i = 0; i < 64; ++i) {
+            if (queue_.try_dequeue(value)) return QueueStatus::Ok;
+            if (closed_.load(std::memory_order_acquire)) break;
+        }
+
+        std::unique_lock<std::mutex> lock(mtx_);
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        QueueStatus status = QueueStatus::Ok;
+        while (!queue_.try_dequeue(value)) {
+            if (closed_.load(std::memory_order_acquire)) {
+                if (drained()) {
+                    // 入队方的 fetch_sub 在入队之后：看到 0 就一定能看到它入的元素
+                    if (queue_.try_dequeue(value)) break;
+                    status = QueueStatus::Closed; // 关闭且已空
+                    break;
+                }
+                // 关闭时还有生产者在入队：窗口只有一次 enqueue 那么长，让一下再看
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+                continue;
+            }
+            if (deadline == nullptr) {
+                cv_not_empty.wait(lock);
+            } else if (cv_not_empty.wait_until(lock, *deadline) == std::cv_status::timeout) {
+                if (queue_.try_dequeue(value)) break;
+                if (drained()) {
+                    status = queue_.try_dequeue(value) ? QueueStatus::Ok : QueueStatus::Closed;
+                } else {
+                    status = QueueStatus::Timeout;
+                }
+                break;
+            }
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+        return status;
+    }
+};
+
+#endif //CONCURRENCY_STUDY_SAFEQUEUE_H
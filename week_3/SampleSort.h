@@ -0,0 +1,161 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_SAMPLESORT_H
+#define CONCURRENCY_STUDY_SAMPLESORT_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <cstdint>
+#include <cstddef>
+
+#include "ParallelSort.h"
+
+// =========================
+// 并行样本排序 (sample sort)
+// 归并排序要 log n 层合并，每层把全部数据读写一遍；样本排序只做一次划分：
+//   1. 随机抽 k × 过采样倍数 个样本排好，等距取 k-1 个分隔符 → k 个桶，桶大小大致相等
+//   2. 各块并行分类：分隔符按 Eytzinger（层序）布局成一棵隐式二叉树，
+//      每个元素走 log k 步 j = 2j + comp(tree[j], x)，比较结果直接当下标用，没有条件分支可猜错；
+//      桶号记在一个 oracle 数组里，同时数每块每桶的个数
+//   3. 前缀和得到每块每桶的写入起点，各块并行把元素搬进 scratch 的对应位置
+//   4. 各桶独立并行排序（std::sort），排完搬回原数组
+// 分隔符有重复（数据里有大量相等键）时，等于某个重复分隔符的元素单独进“相等桶”，不用再排
+// 只要求比较器是严格弱序，和 parallel_merge_sort 的签名一样
+// =========================
+
+namespace sample_detail {
+
+constexpr size_t kOversample = 16;
+
+inline size_t log2_floor(size_t x) {
+    size_t r = 0;
+    while (x >>= 1) ++r;
+    return r;
+}
+
+template<typename RandomIt, typename Compare>
+void sample_sort(WorkStealingPool& pool, RandomIt data, size_t n, Compare& comp) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using D = std::ptrdiff_t;
+
+    // 桶数 k：2 的幂，至少每个工人 4 个桶（给偷任务留余量），桶也别大到放不进缓存
+    size_t want = std::max(pool.thread_count() * 4, n / (size_t(1) << 16));
+    size_t k = 2;
+    while (k < want && k < 1024) k *= 2;
+    size_t levels = log2_floor(k);
+
+    // 1. 抽样（固定种子，同样的输入每次划分一样），取分隔符
+    std::vector<T> sample;
+    sample.reserve(k * kOversample);
+    std::mt19937_64 gen(n);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    for (size_t i = 0; i < k * kOversample; ++i) sample.push_back(data[static_cast<D>(pick(gen))]);
+    std::sort(sample.begin(), sample.end(), comp);
+    std::vector<T> splitters;
+    splitters.reserve(k - 1);
+    for (size_t i = 1; i < k; ++i) splitters.push_back(sample[i * kOversample - 1]);
+
+    // 分隔符里有相等的：打开相等桶（桶 b 的相等桶是 2b+1，普通桶是 2b）
+    bool equality = false;
+    for (size_t i = 1; i < splitters.size() && !equality; ++i) {
+        equality = !comp(splitters[i - 1], splitters[i]);
+    }
+    size_t buckets = equality ? 2 * k : k;
+
+    // Eytzinger 布局：tree[1..k-1]，中序遍历恰好是有序的分隔符
+    std::vector<T> tree(k, splitters[0]); // 下标 0 不用；拿一个分隔符占位，不要求 T 能默认构造
+    size_t next = 0;
+    auto build = [&](auto& self, size_t j) -> void {
+        if (j >= k) return;
+        self(self, 2 * j);
+        tree[j] = splitters[next++];
+        self(self, 2 * j + 1);
+    };
+    build(build, 1);
+
+    auto classify = [&](const T& x) -> size_t {
+        size_t j = 1;
+        for (size_t l = 0; l < levels; ++l) j = 2 * j + static_cast<size_t>(comp(tree[j], x));
+        size_t b = j - k; // splitters[b-1] < x <= splitters[b]
+        if (!equality) return b;
+        return 2 * b + static_cast<size_t>(b < k - 1 && !comp(x, splitters[b]));
+    };
+
+    // 2. 分类：每块一份计数，桶号存进 oracle，散射时不用再走一遍树
+    size_t blocks = std::max<size_t>(1, std::min(pool.thread_count() * 2, n / 16384));
+    auto block_lo = [&](size_t b) { return n * b / blocks; };
+    std::unique_ptr<uint16_t[]> oracle(new uint16_t[n]); // 不清零：每个位置都由分类那一遍写
+    std::vector<std::vector<size_t>> counts(blocks, std::vector<size_t>(buckets));
+
+    auto count = [&](size_t b) {
+        auto& c = counts[b];
+        for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) {
+            size_t bucket = classify(data[static_cast<D>(i)]);
+            oracle[i] = static_cast<uint16_t>(bucket);
+            ++c[bucket];
+        }
+    };
+    sort_detail::fork_each(pool, 0, blocks, count);
+
+    // 3. 前缀和 → 每块每桶的写入起点；顺便记下每个桶的边界
+    std::vector<size_t> bucket_lo(buckets + 1);
+    size_t running = 0;
+    for (size_t bucket = 0; bucket < buckets; ++bucket) {
+        bucket_lo[bucket] = running;
+        for (size_t b = 0; b < blocks; ++b) {
+            size_t c = counts[b][bucket];
+            counts[b][bucket] = running;
+            running += c;
+        }
+    }
+    bucket_lo[buckets] = n;
+
+    sort_detail::ScratchBuffer<T> scratch(pool, n, data);
+    auto scatter = [&](size_t b) {
+        auto& offset = counts[b];
+        for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) {
+            scratch[offset[oracle[i]]++] = std::move(data[static_cast<D>(i)]);
+        }
+    };
+    sort_detail::fork_each(pool, 0, blocks, scatter);
+
+    // 4. 各桶排好、搬回；相等桶里都是同一个键，直接搬
+    auto finish = [&](size_t bucket) {
+        T* first = scratch.data() + bucket_lo[bucket];
+        T* last = scratch.data() + bucket_lo[bucket + 1];
+        if (!(equality && bucket % 2 == 1)) std::sort(first, last, comp);
+        std::move(first, last, data + static_cast<D>(bucket_lo[bucket]));
+    };
+    sort_detail::fork_each(pool, 0, buckets, finish);
+}
+
+} // namespace sample_detail
+
+// =========================
+// parallel_sample_sort(pool, begin, end, comp)
+// 和 parallel_merge_sort 一样的签名，原地、不稳定；额外占用 n 个元素 + n 个 uint16 的临时空间
+// 比较代价高（字符串、结构体自定义比较）的时候一次划分比 log n 层合并划算
+// =========================
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_sample_sort(WorkStealingPool& pool, RandomIt begin, RandomIt end, Compare comp = Compare()) {
+    auto n = static_cast<size_t>(std::distance(begin, end));
+    if (n < (size_t(1) << 14)) {
+        std::sort(begin, end, comp);
+        return;
+    }
+    pool.run([&]() { sample_detail::sample_sort(pool, begin, n, comp); });
+}
+
+// 用默认工作窃取池
+template<typename RandomIt, typename Compare = std::less<>>
+void parallel_sample_sort(RandomIt begin, RandomIt end, Compare comp = Compare()) {
+    parallel_sample_sort(default_work_stealing_pool(), begin, end, comp);
+}
+
+#endif //CONCURRENCY_STUDY_SAMPLESORT_H
@@ -0,0 +1,108 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "SampleSort.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 一条“订单”：按金额降序、同金额按 id 升序
+struct Order {
+    double amount = 0;
+    uint64_t id = 0;
+    uint32_t region = 0;
+};
+
+struct ByAmountDesc {
+    bool operator()(const Order& a, const Order& b) const {
+        if (a.amount != b.amount) return a.amount > b.amount;
+        return a.id < b.id;
+    }
+};
+
+bool same(const std::vector<Order>& a, const std::vector<Order>& b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].id != b[i].id) return false;
+    }
+    return true;
+}
+
+bool same(const std::vector<int>& a, const std::vector<int>& b) { return a == b; }
+
+template<typename T, typename Compare>
+void compare(const std::string& name, const std::vector<T>& source, Compare comp, WorkStealingPool& pool) {
+    std::vector<T> expect = source;
+    auto start = Clock::now();
+    std::sort(expect.begin(), expect.end(), comp);
+    double base = ms_since(start);
+
+    std::vector<T> data = source;
+    start = Clock::now();
+    parallel_merge_sort(pool, data.begin(), data.end(), comp);
+    double merge = ms_since(start);
+    bool merge_ok = same(data, expect);
+
+    data = source;
+    start = Clock::now();
+    parallel_sample_sort(pool, data.begin(), data.end(), comp);
+    double sample = ms_since(start);
+    bool sample_ok = same(data, expect);
+
+    std::cout << name << ": std::sort " << base << " ms，归并 " << merge << " ms，样本 " << sample << " ms"
+              << (merge_ok && sample_ok ? "" : " 结果不一致!") << std::endl;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    WorkStealingPool& pool = default_work_stealing_pool();
+    std::cout << "工人数: " << pool.thread_count() << std::endl;
+    std::mt19937_64 gen(42);
+
+    // 1. 自定义比较器的结构体：比较贵，样本排序只比较 log k 次就定桶
+    {
+        std::vector<Order> orders(10000000);
+        std::lognormal_distribution<double> amount(3.0, 1.5);
+        for (size_t i = 0; i < orders.size(); ++i) {
+            orders[i].amount = static_cast<double>(static_cast<int64_t>(amount(gen) * 100)) / 100; // 分为单位，有重复
+            orders[i].id = i;
+            orders[i].region = static_cast<uint32_t>(gen() % 32);
+        }
+        std::shuffle(orders.begin(), orders.end(), gen);
+        compare("1000 万订单 (金额降序)", orders, ByAmountDesc(), pool);
+    }
+
+    // 2. 普通随机 int
+    {
+        std::vector<int> v(20000000);
+        for (auto& x : v) x = static_cast<int>(gen());
+        compare("2000 万随机 int        ", v, std::less<>(), pool);
+    }
+
+    // 3. 只有 100 种取值：分隔符大量重复，走相等桶，不会退化成一个巨大的桶
+    {
+        std::vector<int> v(20000000);
+        for (auto& x : v) x = static_cast<int>(gen() % 100);
+        compare("2000 万 int (100 种值) ", v, std::less<>(), pool);
+    }
+
+    return 0;
+}
@@ -0,0 +1,319 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_SEGMENTEDQUEUE_H
+#define CONCURRENCY_STUDY_SEGMENTEDQUEUE_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <array>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// =========================
+// 无界 MPMC 无锁队列：一串定长的段（每段 1024 个槽）连成链表
+//   入队：对尾段的 enq 下标 fetch_add 领一个槽，写进去；段满了就挂一个新段
+//   出队：对头段的 deq 下标 fetch_add 领一个槽，等它写好再取；段取空了头指针挪到下一段
+// 热路径上只有一次 fetch_add + 一次 CAS，生产者之间不抢锁，16 个以上生产者也不会排队
+//
+// 段的回收：出队把头指针挪走以后，旧段可能还有线程在用（刚领了下标还没写/没取），
+// 用风险指针（hazard pointer）确认没人用了，再洗干净放回本队列的小池子里给下一次挂段用，
+// 所以稳态下不会再分配内存
+// =========================
+namespace segmented_detail {
+
+// 全进程共享的风险指针表：每个线程一条记录，两个指针（头段、尾段）
+// 记录只增不删，线程退出时标记为空闲，给后来的线程复用
+struct HazardRecord {
+    std::atomic<void*> ptr[2] = {nullptr, nullptr};
+    std::atomic<bool> active{false};
+    HazardRecord* next = nullptr;
+};
+
+class HazardDomain {
+public:
+    static HazardDomain& instance() {
+        static HazardDomain domain;
+        return domain;
+    }
+
+    // 当前线程的记录
+    static HazardRecord& local() {
+        thread_local Holder holder;
+        return *holder.record;
+    }
+
+    // 把现在所有线程保护着的指针拍一份下来
+    void collect(std::vector<void*>& out) const {
+        out.clear();
+        for (HazardRecord* r = head_.load(std::memory_order_acquire); r; r = r->next) {
+            for (auto& p : r->ptr) {
+                void* v = p.load(std::memory_order_seq_cst);
+                if (v) out.push_back(v);
+            }
+        }
+        std::sort(out.begin(), out.end());
+    }
+
+private:
+    struct Holder {
+        HazardRecord* record;
+        Holder() : record(instance().acquire()) {}
+        ~Holder() {
+            for (auto& p : record->ptr) p.store(nullptr, std::memory_order_release);
+            record->active.store(false, std::memory_order_release);
+        }
+    };
+
+    HazardRecord* acquire() {
+        for (HazardRecord* r = head_.load(std::memory_order_acquire); r; r = r->next) {
+            bool expected = false;
+            if (!r->active.load(std::memory_order_relaxed) &&
+                r->active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                return r;
+            }
+        }
+        auto* r = new HazardRecord; // 只增不删：进程结束前一直挂在表上
+        r->active.store(true, std::memory_order_relaxed);
+        HazardRecord* old = head_.load(std::memory_order_relaxed);
+        do {
+            r->next = old;
+        } while (!head_.compare_exchange_weak(old, r, std::memory_order_release, std::memory_order_relaxed));
+        return r;
+    }
+
+    std::atomic<HazardRecord*> head_{nullptr};
+};
+
+} // namespace segmented_detail
+
+template<typename T>
+class SegmentedQueue {
+public:
+    static constexpr size_t kSegmentSize = 1024;
+
+    SegmentedQueue() {
+        Segment* s = new Segment;
+        allocated_.store(1, std::memory_order_relaxed);
+        head_.store(s, std::memory_order_relaxed);
+        tail_.store(s, std::memory_order_relaxed);
+    }
+
+    SegmentedQueue(const SegmentedQueue&) = delete;
+    SegmentedQueue& operator=(const SegmentedQueue&) = delete;
+
+    // 析构时不能再有别的线程在用
+    ~SegmentedQueue() {
+        Segment* s = head_.load(std::memory_order_relaxed);
+        while (s) {
+            Segment* next = s->next.load(std::memory_order_relaxed);
+            destroy_ready_slots(s);
+            delete s;
+            s = next;
+        }
+        for (Segment* r : retired_) delete r;
+        for (auto& p : pool_) delete p.load(std::memory_order_relaxed);
+    }
+
+    // 入队：不会失败，不加锁
+    void enqueue(T value) {
+        auto& hp = segmented_detail::HazardDomain::local().ptr[0];
+        while (true) {
+            Segment* seg = protect(tail_, hp);
+            size_t i = seg->enq.fetch_add(1, std::memory_order_acq_rel);
+            if (i < kSegmentSize) {
+                Slot& slot = seg->slots[i];
+                new (slot.ptr()) T(std::move(value));
+                uint32_t expected = kEmpty;
+                if (slot.state.compare_exchange_strong(expected, kReady, std::memory_order_acq_rel)) break;
+                // 出队的人等不及，把这个槽作废了：把值拿回来，换个槽再试
+                value = std::move(*slot.ptr());
+                slot.ptr()->~T();
+                continue;
+            }
+
+            // 这一段满了：挂一个新段（新段的 0 号槽直接放我们的值），或者帮别人把 tail 挪过去
+            Segment* next = seg->next.load(std::memory_order_acquire);
+            if (next == nullptr) {
+                Segment* fresh = obtain_segment();
+                fresh->id = seg->id + 1;
+                new (fresh->slots[0].ptr()) T(std::move(value));
+                fresh->slots[0].state.store(kReady, std::memory_order_relaxed);
+                fresh->enq.store(1, std::memory_order_relaxed);
+                if (seg->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel)) {
+                    tail_.compare_exchange_strong(seg, fresh, std::memory_order_acq_rel);
+                    break;
+                }
+                // 别人先挂上了：值拿回来，段还回池子
+                value = std::move(*fresh->slots[0].ptr());
+                fresh->slots[0].ptr()->~T();
+                fresh->slots[0].state.store(kEmpty, std::memory_order_relaxed);
+                fresh->enq.store(0, std::memory_order_relaxed);
+                recycle(fresh);
+            }
+            tail_.compare_exchange_strong(seg, next, std::memory_order_acq_rel);
+        }
+        hp.store(nullptr, std::memory_order_release);
+    }
+
+    // 出队：空了返回 false，不阻塞
+    bool try_dequeue(T& out) {
+        auto& hp = segmented_detail::HazardDomain::local().ptr[0];
+        bool got = false;
+        while (true) {
+            Segment* seg = protect(head_, hp);
+            size_t d = seg->deq.load(std::memory_order_acquire);
+            size_t e = seg->enq.load(std::memory_order_acquire);
+            if (d >= kSegmentSize) {
+                if (!advance_head(seg, hp)) break; // 这段取完了，后面还没有新段：空
+                continue;
+            }
+            if (d >= e) break; // 没有已领走的入队槽：空（不去领下标，免得白白作废一堆槽）
+
+            size_t i = seg->deq.fetch_add(1, std::memory_order_acq_rel);
+            if (i >= kSegmentSize) continue;
+
+            Slot& slot = seg->slots[i];
+            if (!wait_ready(slot)) continue; // 入队的人迟迟没写，作废这个槽，换下一个
+            out = std::move(*slot.ptr());
+            slot.ptr()->~T();
+            got = true;
+            break;
+        }
+        hp.store(nullptr, std::memory_order_release);
+        return got;
+    }
+
+    // 近似长度：按段编号和两端下标估算，不遍历链表
+    size_t size_approx() const {
+        auto& rec = segmented_detail::HazardDomain::local();
+        Segment* h = protect(head_, rec.ptr[0]);
+        Segment* t = protect(tail_, rec.ptr[1]);
+        uint64_t enq = t->id * kSegmentSize + std::min(t->enq.load(std::memory_order_acquire), kSegmentSize);
+        uint64_t deq = h->id * kSegmentSize + std::min(h->deq.load(std::memory_order_acquire), kSegmentSize);
+        rec.ptr[1].store(nullptr, std::memory_order_release);
+        rec.ptr[0].store(nullptr, std::memory_order_release);
+        return enq > deq ? static_cast<size_t>(enq - deq) : 0;
+    }
+
+    // 一共 new 过多少段：稳态下应该不再增长
+    size_t segments_allocated() const { return allocated_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kEmpty = 0;
+    static constexpr uint32_t kReady = 1;
+    static constexpr uint32_t kAbandoned = 2; // 出队方放弃了，入队方要换槽
+    static constexpr size_t kPoolSize = 8;
+
+    struct Slot {
+        std::atomic<uint32_t> state{kEmpty};
+        alignas(T) unsigned char storage[sizeof(T)];
+        T* ptr() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    struct Segment {
+        alignas(64) std::atomic<size_t> enq{0};
+        alignas(64) std::atomic<size_t> deq{0};
+        alignas(64) std::atomic<Segment*> next{nullptr};
+        uint64_t id = 0; // 第几段，size_approx 用
+        Slot slots[kSegmentSize];
+    };
+
+    // 读一个共享指针并登记为风险指针；登记后再读一次确认没变，才算保护住了
+    static Segment* protect(const std::atomic<Segment*>& src, std::atomic<void*>& hp) {
+        Segment* p = src.load(std::memory_order_acquire);
+        while (true) {
+            hp.store(p, std::memory_order_seq_cst);
+            Segment* q = src.load(std::memory_order_seq_cst);
+            if (q == p) return p;
+            p = q;
+        }
+    }
+
+    // 等入队方写好：先自旋一会儿，还没好就把槽作废（CAS 失败说明刚好写好了）
+    static bool wait_ready(Slot& slot) {
+        for (int i = 0; i < 256; ++i) {
+            if (slot.state.load(std::memory_order_acquire) == kReady) return true;
+        }
+        uint32_t expected = kEmpty;
+        return !slot.state.compare_exchange_strong(expected, kAbandoned, std::memory_order_acq_rel);
+    }
+
+    // 头段已经取完：挪到下一段，把旧段退休。返回 false 表示还没有下一段
+    // hp 是调用者保护 seg 的风险指针：退休前先放掉，旧段才能马上回收（之后调用者不再碰 seg）
+    bool advance_head(Segment* seg, std::atomic<void*>& hp) {
+        Segment* next = seg->next.load(std::memory_order_acquire);
+        if (next == nullptr) return false;
+        Segment* expected = seg;
+        tail_.compare_exchange_strong(expected, next, std::memory_order_acq_rel); // tail 不能落在 head 后面
+        expected = seg;
+        if (head_.compare_exchange_strong(expected, next, std::memory_order_acq_rel)) {
+            hp.store(nullptr, std::memory_order_release);
+            retire(seg);
+        }
+        return true;
+    }
+
+    // 退休：一个段一个段地来（每 1024 个元素一次），这里用一把锁无所谓
+    void retire(Segment* seg) {
+        std::lock_guard<std::mutex> lock(retire_mtx_);
+        retired_.push_back(seg);
+        segmented_detail::HazardDomain::instance().collect(hazards_);
+        auto still_used = [this](Segment* s) {
+            return std::binary_search(hazards_.begin(), hazards_.end(), static_cast<void*>(s));
+        };
+        size_t kept = 0;
+        for (Segment* s : retired_) {
+            if (still_used(s)) retired_[kept++] = s;
+            else recycle(s);
+        }
+        retired_.resize(kept);
+    }
+
+    // 洗干净放回池子；池子满了才真的释放
+    void recycle(Segment* seg) {
+        destroy_ready_slots(seg);
+        for (auto& slot : seg->slots) slot.state.store(kEmpty, std::memory_order_relaxed);
+        seg->enq.store(0, std::memory_order_relaxed);
+        seg->deq.store(0, std::memory_order_relaxed);
+        seg->next.store(nullptr, std::memory_order_relaxed);
+        for (auto& p : pool_) {
+            Segment* expected = nullptr;
+            if (p.compare_exchange_strong(expected, seg, std::memory_order_release)) return;
+        }
+        delete seg;
+    }
+
+    Segment* obtain_segment() {
+        for (auto& p : pool_) {
+            if (p.load(std::memory_order_relaxed) == nullptr) continue;
+            Segment* s = p.exchange(nullptr, std::memory_order_acquire); // exchange 拿到就是独占的
+            if (s) return s;
+        }
+        allocated_.fetch_add(1, std::memory_order_relaxed);
+        return new Segment;
+    }
+
+    static void destroy_ready_slots(Segment* seg) {
+        size_t e = std::min(seg->enq.load(std::memory_order_relaxed), kSegmentSize);
+        for (size_t i = seg->deq.load(std::memory_order_relaxed); i < e; ++i) {
+            if (seg->slots[i].state.load(std::memory_order_relaxed) == kReady) seg->slots[i].ptr()->~T();
+        }
+    }
+
+    alignas(64) std::atomic<Segment*> head_{nullptr};
+    alignas(64) std::atomic<Segment*> tail_{nullptr};
+    alignas(64) std::array<std::atomic<Segment*>, kPoolSize> pool_{};
+    std::atomic<size_t> allocated_{0};
+
+    std::mutex retire_mtx_;
+    std::vector<Segment*> retired_;
+    std::vector<void*> hazards_;
+};
+
+#endif //CONCURRENCY_STUDY_SEGMENTEDQUEUE_H
@@ -0,0 +1,127 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "SafeQueue.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// producers 个生产者各放 per_producer 个，consumers 个消费者一直取到关闭；返回 M items/s
+template<typename Queue>
+double run(Queue& q, int producers, int consumers, uint64_t per_producer) {
+    std::atomic<uint64_t> sum{0};
+    auto start = Clock::now();
+
+    std::vector<std::thread> cs;
+    for (int c = 0; c < consumers; ++c) {
+        cs.emplace_back([&]() {
+            uint64_t local = 0, v = 0;
+            while (q.consume(v)) local += v;
+            sum.fetch_add(local);
+        });
+    }
+    std::vector<std::thread> ps;
+    for (int p = 0; p < producers; ++p) {
+        ps.emplace_back([&q, p, per_producer]() {
+            for (uint64_t i = 0; i < per_producer; ++i) q.produce(static_cast<uint64_t>(p) * per_producer + i);
+        });
+    }
+    for (auto& t : ps) t.join();
+    q.close();
+    for (auto& t : cs) t.join();
+
+    double sec = std::chrono::duration<double>(Clock::now() - start).count();
+    uint64_t n = per_producer * static_cast<uint64_t>(producers);
+    if (sum.load() != n * (n - 1) / 2) std::cout << "  (校验失败!)";
+    return static_cast<double>(n) / sec / 1e6;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    const uint64_t total = 4000000;
+
+    for (int producers : {1, 4, 16, 32}) {
+        uint64_t per = total / static_cast<uint64_t>(producers);
+
+        SafeQueue<uint64_t> locked(1 << 16);
+        double a = run(locked, producers, 4, per);
+
+        SafeQueue<uint64_t, UnboundedLockFree> lockfree;
+        double b = run(lockfree, producers, 4, per);
+
+        std::cout << producers << " 个生产者 / 4 个消费者: 有锁 " << a << " M/s，分段无锁 " << b
+                  << " M/s（共分配 " << lockfree.segments_allocated() << " 个段，每段 "
+                  << SegmentedQueue<uint64_t>::kSegmentSize << " 个槽）" << std::endl;
+    }
+
+    // 稳态：消费者跟得上时（队列里始终只有几百个），段在退休后被洗干净复用，不再分配
+    {
+        SafeQueue<uint64_t, UnboundedLockFree> steady;
+        std::thread consumer([&steady]() {
+            uint64_t v = 0;
+            while (steady.consume(v)) {}
+        });
+        for (uint64_t i = 0; i < 4000000; ++i) {
+            steady.produce(i);
+            if ((i & 255) == 255) {
+                while (steady.size() > 256) std::this_thread::yield();
+            }
+        }
+        steady.close();
+        consumer.join();
+        std::cout << "稳态 400 万个元素：只分配了 " << steady.segments_allocated() << " 个段" << std::endl;
+    }
+
+    // 无界：生产者一口气塞一百万个，不会因为满了卡住；之后消费者取完
+    SafeQueue<uint64_t, UnboundedLockFree> burst;
+    for (uint64_t i = 0; i < 1000000; ++i) burst.produce(i);
+    std::cout << "突发写入后长度约 " << burst.size() << "，分配了 " << burst.segments_allocated() << " 个段" << std::endl;
+    uint64_t v = 0, got = 0;
+    while (burst.consume_for(v, std::chrono::milliseconds(1)) == QueueStatus::Ok) ++got;
+    std::cout << "取出 " << got << " 个，剩余 " << burst.size() << std::endl;
+
+    // 生产者还在写的时候 close()：produce 返回 true 的元素一个都不能丢
+    {
+        int lost_rounds = 0;
+        for (int round = 0; round < 200; ++round) {
+            SafeQueue<uint64_t, UnboundedLockFree> q;
+            std::atomic<uint64_t> accepted{0}, taken{0};
+            std::vector<std::thread> ts;
+            for (int c = 0; c < 2; ++c) {
+                ts.emplace_back([&q, &taken]() {
+                    uint64_t x = 0, local = 0;
+                    while (q.consume(x)) ++local;
+                    taken.fetch_add(local);
+                });
+            }
+            for (int p = 0; p < 4; ++p) {
+                ts.emplace_back([&q, &accepted]() {
+                    uint64_t local = 0;
+                    while (q.produce(local)) ++local;
+                    accepted.fetch_add(local);
+                });
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            q.close();
+            for (auto& t : ts) t.join();
+            if (accepted.load() != taken.load()) ++lost_rounds;
+        }
+        std::cout << "边写边关 200 轮: " << (lost_rounds == 0 ? "接受的元素全部取到" : "有元素丢失!") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,270 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_SHARDEDEXECUTOR_H
+#define CONCURRENCY_STUDY_SHARDEDEXECUTOR_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+
+#include "CpuTopology.h"
+#include "SpscRing.h"
+
+// =========================
+// 无共享的 thread-per-core 执行器
+// 每个核一个绑定线程，自己的运行队列只有自己碰；核与核之间只通过 N×N 个单生产者单消费者邮箱通信：
+// mailbox[from][to] 只有 from 核写、只有 to 核读，所以收发都不需要锁，也不会有多个核抢同一个缓存行
+// 外部线程（不是任何一个核）提交的任务走每个核一个的带锁收件箱，那是慢路径
+// 邮箱就是 SpscRing：收件时一次把整个邮箱搬空，只发布一次下标
+// =========================
+class ShardedExecutor {
+public:
+    using Task = std::function<void()>;
+    static constexpr size_t kNotACore = static_cast<size_t>(-1);
+
+    // cores = 0 表示每个逻辑 CPU 一个核线程；mailbox_capacity 会向上取到 2 的幂
+    explicit ShardedExecutor(size_t cores = 0, bool pin = true, size_t mailbox_capacity = 1024) {
+        std::vector<int> cpus;
+        for (const auto& node : CpuTopology::discover()) {
+            cpus.insert(cpus.end(), node.cpus.begin(), node.cpus.end());
+        }
+        if (cores == 0) cores = cpus.size();
+        if (cores == 0) cores = 1;
+
+        for (size_t i = 0; i < cores; ++i) cores_.push_back(std::make_unique<Core>());
+        mailboxes_.resize(cores * cores);
+        for (auto& m : mailboxes_) m = std::make_unique<Mailbox>(mailbox_capacity);
+
+        for (size_t i = 0; i < cores; ++i) {
+            int cpu = (pin && !cpus.empty()) ? cpus[i % cpus.size()] : -1;
+            cores_[i]->thread = std::thread([this, i, cpu]() { run(i, cpu); });
+        }
+    }
+
+    ShardedExecutor(const ShardedExecutor&) = delete;
+    ShardedExecutor& operator=(const ShardedExecutor&) = delete;
+
+    // 析构：之后外部线程的提交一律被拒绝；核线程要等全局没有未完成的任务才退出，
+    // 所以析构前接受的任务、以及它们在任何核上继续派生的任务（包括暂存区里的）都会跑完
+    ~ShardedExecutor() {
+        stop_.store(true);
+        for (auto& c : cores_) wake(*c);
+        for (auto& c : cores_) {
+            if (c->thread.joinable()) c->thread.join();
+        }
+    }
+
+    size_t core_count() const { return cores_.size(); }
+
+    // 当前线程是第几个核；不是核线程返回 kNotACore
+    static size_t current_core() { return current_core_; }
+
+    // 把 fn 发给 core 执行。核线程调用时走无锁 SPSC 邮箱（满了先暂存在本核，之后重试，从不阻塞）
+    // 外部线程调用时走目标核的带锁收件箱；执行器已经在析构时外部提交返回 false
+    // core 越界抛 std::out_of_range
+    bool submit_to(size_t core, Task fn) {
+        if (core >= cores_.size()) throw std::out_of_range("ShardedExecutor::submit_to: core 越界");
+        size_t from = current_core_;
+        Core& target = *cores_[core];
+
+        if (from == kNotACore || current_executor_ != this) {
+            // 先登记再看 stop_：和核线程退出前的检查配对，见 quiescent()
+            external_submitted_.fetch_add(1);
+            if (stop_.load()) {
+                external_rejected_.fetch_add(1);
+                return false;
+            }
+            {
+                std::lock_guard<std::mutex> lock(target.inbox_mtx);
+                target.inbox.push_back(std::move(fn));
+            }
+            target.inbox_nonempty.store(true, std::memory_order_release);
+            notify(target);
+            return true;
+        }
+
+        // 核线程只会在执行任务时提交，那个任务还没计入 executed，所以这里不用看 stop_
+        Core& self = *cores_[from];
+        self.submitted.store(self.submitted.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (from == core) {
+            target.local.push_back(std::move(fn)); // 发给自己：直接进本地运行队列
+            return true;
+        }
+
+        auto& pending = self.overflow[core];
+        if (!pending.empty() || !mailbox(from, core).try_push(fn)) {
+            pending.push_back(std::move(fn)); // 邮箱满：保持顺序，排在暂存区后面
+            return true;
+        }
+        notify(target);
+        return true;
+    }
+
+private:
+    using Mailbox = SpscRing<Task>;
+
+    struct Core {
+        std::thread thread;
+        std::deque<Task> local;                   // 只有本核访问
+        std::vector<std::deque<Task>> overflow;   // 发往各核但邮箱满了的任务，只有本核访问
+
+        std::mutex inbox_mtx;                     // 外部线程的慢路径
+        std::deque<Task> inbox;
+        std::atomic<bool> inbox_nonempty{false};
+
+        std::mutex park_mtx;                      // 没活干时睡在这里
+        std::condition_variable park_cv;
+        std::atomic<bool> sleeping{false};
+
+        // 只有本核写：本核提交出去的任务数 / 本核跑完的任务数，析构时用来判断全局是否已经没活
+        std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t> executed{0};
+    };
+
+    Mailbox& mailbox(size_t from, size_t to) { return *mailboxes_[from * cores_.size() + to]; }
+
+    // 生产者侧：先发布消息，再看对方是不是睡了（和 park 里的“先声明要睡，再检查一遍”配对）
+    void notify(Core& target) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (target.sleeping.load(std::memory_order_relaxed)) wake(target);
+    }
+
+    static void wake(Core& target) {
+        std::lock_guard<std::mutex> lock(target.park_mtx);
+        target.park_cv.notify_one();
+    }
+
+    // 一轮轮询：收邮件、收外部任务、重发暂存、跑本地队列。返回这一轮干了多少活
+    size_t poll(size_t id) {
+        Core& self = *cores_[id];
+        size_t n = cores_.size();
+        size_t work = 0;
+
+        for (size_t from = 0; from < n; ++from) {
+            if (from == id) continue;
+            work += mailbox(from, id).consume_all([&self](Task&& task) {
+                self.local.push_back(std::move(task));
+            });
+        }
+
+        if (self.inbox_nonempty.load(std::memory_order_acquire)) {
+            std::lock_guard<std::mutex> lock(self.inbox_mtx);
+            for (auto& t : self.inbox) self.local.push_back(std::move(t));
+            work += self.inbox.size();
+            self.inbox.clear();
+            self.inbox_nonempty.store(false, std::memory_order_relaxed);
+        }
+
+        for (size_t to = 0; to < n; ++to) {
+            auto& pending = self.overflow[to];
+            if (pending.empty()) continue;
+            size_t sent = mailbox(id, to).try_push_n(pending.begin(), pending.size());
+            pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(sent));
+            if (sent > 0) notify(*cores_[to]);
+        }
+
+        // 只跑这一轮开始时已有的任务，新产生的留到下一轮，保证邮箱能及时被收
+        size_t batch = self.local.size();
+        for (size_t i = 0; i < batch; ++i) {
+            Task t = std::move(self.local.front());
+            self.local.pop_front();
+            if (t) t();
+            self.executed.store(self.executed.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            ++work;
+        }
+        return work;
+    }
+
+    // 全局没有未完成的任务（不在任何队列、邮箱、暂存区里，也没有正在跑的）
+    // 先读所有 executed，再读所有 submitted：executed 读到的只会偏小，submitted 只会偏大，
+    // 两边相等说明在读完 executed 的那一刻两者真的相等，而 stop_ 之后外部提交都被拒绝，不会再有新任务
+    bool quiescent() const {
+        uint64_t executed = external_rejected_.load();
+        for (const auto& c : cores_) executed += c->executed.load(std::memory_order_acquire);
+        uint64_t submitted = external_submitted_.load();
+        for (const auto& c : cores_) submitted += c->submitted.load(std::memory_order_relaxed);
+        return executed == submitted;
+    }
+
+    // 本核还有没处理的任务（本地队列 / 邮箱 / 外部收件箱）
+    bool has_incoming(size_t id) {
+        Core& self = *cores_[id];
+        if (!self.local.empty()) return true;
+        if (self.inbox_nonempty.load(std::memory_order_acquire)) return true;
+        for (size_t from = 0; from < cores_.size(); ++from) {
+            if (from != id && !mailbox(from, id).empty()) return true;
+        }
+        return false;
+    }
+
+    // 再加上还没发出去的暂存消息
+    bool has_work(size_t id) {
+        if (has_incoming(id)) return true;
+        for (const auto& pending : cores_[id]->overflow) {
+            if (!pending.empty()) return true;
+        }
+        return false;
+    }
+
+    void park(size_t id) {
+        Core& self = *cores_[id];
+        std::unique_lock<std::mutex> lock(self.park_mtx);
+        self.sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_work(id) && !stop_.load()) {
+            // 有暂存的消息时不会走到这里；超时只是兜底
+            self.park_cv.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        self.sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    void run(size_t id, int cpu) {
+        current_core_ = id;
+        current_executor_ = this;
+        if (cpu >= 0) CpuTopology::pin_current_thread({cpu});
+        cores_[id]->overflow.resize(cores_.size());
+
+        int idle_rounds = 0;
+        while (true) {
+            size_t work = poll(id);
+            if (work > 0) {
+                idle_rounds = 0;
+                continue;
+            }
+            if (stop_.load()) {
+                if (quiescent()) break; // 所有核上的任务（包括发给别的核的暂存消息）都跑完才退出
+                std::this_thread::yield();
+                continue;
+            }
+            // 先自旋一会儿（低延迟），还是没活再睡
+            if (++idle_rounds < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            park(id);
+            idle_rounds = 0;
+        }
+    }
+
+    static inline thread_local size_t current_core_ = kNotACore;
+    static inline thread_local const ShardedExecutor* current_executor_ = nullptr;
+
+    std::vector<std::unique_ptr<Core>> cores_;
+    std::vector<std::unique_ptr<Mailbox>> mailboxes_; // [from * N + to]
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> external_submitted_{0}; // 外部线程的提交（含被拒绝的）
+    std::atomic<uint64_t> external_rejected_{0};  // 析构开始后被拒绝的外部提交
+};
+
+#endif //CONCURRENCY_STUDY_SHARDEDEXECUTOR_H
@@ -0,0 +1,126 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <stdexcept>
+#include "ShardedExecutor.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// 等计数器到达目标值（主线程不是核线程，睡一会儿再看）
+void wait_for(const std::atomic<long long>& counter, long long target) {
+    while (counter.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+}
+
+// 1. 跨核消息延迟：0 号核和 1 号核来回传球
+struct PingPong {
+    ShardedExecutor& exec;
+    std::atomic<long long>& hops;
+    long long total;
+
+    // 主线程看到计数到了就会销毁 PingPong，所以成员都在计数之前读出来
+    void hop(size_t at) {
+        long long limit = total;
+        ShardedExecutor& e = exec;
+        long long n = hops.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (n >= limit) return;
+        size_t next = (at == 0) ? 1 : 0;
+        e.submit_to(next, [this, next] { hop(next); });
+    }
+};
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    unsigned int hw = std::thread::hardware_concurrency();
+    size_t cores = hw < 2 ? 2 : hw;
+    ShardedExecutor exec(cores);
+    std::cout << "核线程数: " << exec.core_count() << std::endl;
+
+    {
+        const long long hops_total = 200000;
+        std::atomic<long long> hops{0};
+        PingPong pp{exec, hops, hops_total};
+
+        auto start = Clock::now();
+        exec.submit_to(0, [&pp] { pp.hop(0); });
+        wait_for(hops, hops_total);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+        std::cout << "跨核消息单程延迟: " << static_cast<double>(ns) / hops_total << " ns" << std::endl;
+    }
+
+    // 2. 分区 KV：每个核独占一个分片，所有写都路由到 key 的属主核，分片本身不加锁
+    {
+        const long long ops_per_core = 1000000;
+        size_t n = exec.core_count();
+        std::vector<std::unordered_map<uint64_t, uint64_t>> shards(n);
+        std::atomic<long long> applied{0};
+
+        auto start = Clock::now();
+        for (size_t c = 0; c < n; ++c) {
+            exec.submit_to(c, [&exec, &shards, &applied, c, n, ops_per_core] {
+                std::mt19937_64 gen(c);
+                for (long long i = 0; i < ops_per_core; ++i) {
+                    uint64_t key = gen() % 100000;
+                    size_t owner = key % n;
+                    exec.submit_to(owner, [&shards, &applied, owner, key] {
+                        ++shards[owner][key];
+                        applied.fetch_add(1, std::memory_order_release);
+                    });
+                }
+            });
+        }
+        wait_for(applied, ops_per_core * static_cast<long long>(n));
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+
+        std::cout << "分区 KV: " << ops_per_core * static_cast<long long>(n) << " 次写，耗时 " << ms << " ms，吞吐 "
+                  << static_cast<double>(ops_per_core * static_cast<long long>(n)) / (ms ? ms : 1) / 1000.0
+                  << " M ops/s" << std::endl;
+    }
+
+    // 3. 析构时的收尾：邮箱只有 4 格，每个核一口气往下一个核发 1 万条，大部分卡在暂存区里；
+    //    马上析构，暂存区里的消息也要全部送到；越界的核号抛异常
+    {
+        const long long per_core = 10000;
+        std::atomic<long long> delivered{0};
+        size_t n = 0;
+        bool threw = false;
+        {
+            ShardedExecutor small(cores, false, 4);
+            n = small.core_count();
+            for (size_t c = 0; c < n; ++c) {
+                small.submit_to(c, [&small, &delivered, c, n, per_core] {
+                    for (long long i = 0; i < per_core; ++i) {
+                        small.submit_to((c + 1) % n, [&delivered] { delivered.fetch_add(1, std::memory_order_relaxed); });
+                    }
+                });
+            }
+            try {
+                small.submit_to(n, [] {});
+            } catch (const std::out_of_range&) {
+                threw = true;
+            }
+        }
+        std::cout << "析构收尾: 送达 " << delivered.load() << " / " << per_core * static_cast<long long>(n)
+                  << "，越界核号" << (threw ? "抛异常" : "没抛异常!")
+                  << std::endl;
+    }
+
+    return 0;
+}
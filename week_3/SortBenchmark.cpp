@@ -0,0 +1,376 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+// =========================
+// 排序基准：各种规模 × 各种分布 × 各种线程数，把仓库里的每个排序和 std::sort / std::execution::par 放在一起比
+//   ./Sort_Benchmark --sizes=1K,1M,100M --dists=uniform,zipf --threads=1,4,8 --reps=7 --csv=out.csv --json=out.json
+// 可复现：输入只由 (--seed, 分布名, 规模) 决定，和线程数无关，并行生成；每个组合先预热，再重复计时取中位数和百分位
+// 每次计时前从源数组拷一份（不计时），计时后检查结果有序、元素和不变（不计时）
+// =========================
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <thread>
+#include <limits>
+#include <cstdint>
+#include <cstdlib>
+
+// std::execution::par：MSVC 自带实现；libstdc++ 的实现要链接 TBB，CMake 找到 TBB 时才定义这个宏
+#if defined(_MSC_VER) && !defined(CONCURRENCY_STUDY_HAVE_STD_PAR)
+#define CONCURRENCY_STUDY_HAVE_STD_PAR 1
+#endif
+#if defined(CONCURRENCY_STUDY_HAVE_STD_PAR)
+#include <execution>
+#endif
+
+#include "ParallelSort.h"
+#include "SampleSort.h"
+#include "RadixSort.h"
+#include "SortingNetwork.h"
+#include "DataGen.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    std::vector<size_t> sizes{1000, 100000, 1000000, 10000000};
+    std::vector<std::string> dists{"uniform", "sorted", "reversed", "few_unique", "zipf", "organ_pipe", "nearly_sorted"};
+    std::vector<size_t> threads; // 空 = 1, 2, 4, ... 直到核心数
+    std::vector<std::string> algos; // 空 = 全部
+    size_t warmup = 1;
+    size_t reps = 5;
+    uint64_t seed = 42;
+    std::string csv;
+    std::string json;
+};
+
+// 一个排序变体：parallel = false 的只跑一次（线程数记 1；std::execution::par 记 0 = 由实现决定）
+struct Algo {
+    std::string name;
+    bool parallel;
+    size_t fixed_threads;
+    // 第二个 vector 是 scratch：needs_scratch 的变体在每个用例开始前（计时外）分配一次，n 个元素；其余的拿到空的
+    std::function<void(WorkStealingPool*, std::vector<int>&, std::vector<int>&)> run;
+    bool needs_scratch = false;
+};
+
+struct Result {
+    std::string algo;
+    std::string dist;
+    size_t size;
+    size_t threads;
+    std::vector<double> ms; // 每次重复的耗时，排好序
+    bool ok;
+};
+
+// =========================
+// 命令行
+// =========================
+
+std::vector<std::string> split(const std::string& s) {
+    std::vector<std::string> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+// 1000 / 1K / 10M / 1G（十进制）
+size_t parse_size(const std::string& s) {
+    size_t pos = 0;
+    double v = std::stod(s, &pos);
+    std::string suffix = s.substr(pos);
+    if (suffix == "K" || suffix == "k") v *= 1e3;
+    else if (suffix == "M" || suffix == "m") v *= 1e6;
+    else if (suffix == "G" || suffix == "g") v *= 1e9;
+    else if (!suffix.empty()) throw std::invalid_argument("无法识别的规模: " + s);
+    return static_cast<size_t>(v);
+}
+
+void usage() {
+    std::cout << "用法: Sort_Benchmark [--sizes=1K,1M,...] [--dists=uniform,sorted,reversed,few_unique,zipf,organ_pipe,nearly_sorted]\n"
+                 "                     [--threads=1,2,4,...] [--algos=std_sort,std_par,merge_sort,sample_sort,radix_sort,network_sort]\n"
+                 "                     [--warmup=1] [--reps=5] [--seed=42] [--csv=文件] [--json=文件]\n"
+                 "完整扫描: --sizes=1K,10K,100K,1M,10M,100M,500M（500M 个 int 需要约 6 GB 内存）" << std::endl;
+}
+
+bool parse_args(int argc, char** argv, Config& cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto eq = arg.find('=');
+        std::string key = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+        if (key == "--help" || key == "-h") {
+            usage();
+            return false;
+        } else if (key == "--sizes") {
+            cfg.sizes.clear();
+            for (auto& s : split(value)) cfg.sizes.push_back(parse_size(s));
+        } else if (key == "--dists") {
+            cfg.dists = split(value);
+        } else if (key == "--threads") {
+            cfg.threads.clear();
+            for (auto& s : split(value)) cfg.threads.push_back(static_cast<size_t>(std::stoul(s)));
+        } else if (key == "--algos") {
+            cfg.algos = split(value);
+        } else if (key == "--warmup") {
+            cfg.warmup = static_cast<size_t>(std::stoul(value));
+        } else if (key == "--reps") {
+            cfg.reps = std::max<size_t>(1, static_cast<size_t>(std::stoul(value)));
+        } else if (key == "--seed") {
+            cfg.seed = std::stoull(value);
+        } else if (key == "--csv") {
+            cfg.csv = value;
+        } else if (key == "--json") {
+            cfg.json = value;
+        } else {
+            std::cerr << "未知参数: " << arg << std::endl;
+            usage();
+            return false;
+        }
+    }
+    if (cfg.threads.empty()) {
+        size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t t = 1; t < cores; t *= 2) cfg.threads.push_back(t);
+        cfg.threads.push_back(cores);
+    }
+    return true;
+}
+
+// =========================
+// 输入数据：只由 (seed, 分布, 规模) 决定
+// =========================
+
+uint64_t mix_seed(uint64_t seed, const std::string& dist, size_t n) {
+    uint64_t h = seed ^ (static_cast<uint64_t>(n) * 0x9E3779B97F4A7C15ull);
+    for (char c : dist) h = (h ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+    return h;
+}
+
+// 升序、均匀铺满 int 范围（有少量相等）
+int ramp(size_t i, size_t n) {
+    auto span = static_cast<int64_t>(std::numeric_limits<uint32_t>::max());
+    return static_cast<int>(std::numeric_limits<int>::min() + static_cast<int64_t>(i) * span / static_cast<int64_t>(n));
+}
+
+// 在 pool 上并行生成（见 DataGen.h）：结果和 pool 有几个工人无关，所以用默认池生成、换任何 --threads 测都是同一份输入
+// RandomVector 不清零，每个元素只被并行生成写一遍
+RandomVector<int> make_input(WorkStealingPool& pool, const std::string& dist, size_t n, uint64_t seed) {
+    uint64_t s = mix_seed(seed, dist, n);
+    RandomVector<int> v(n);
+    int* out = v.data();
+    if (dist == "uniform") {
+        parallel_generate(pool, out, n, s, [](Xoshiro256& g) { return static_cast<int>(static_cast<uint32_t>(g())); });
+    } else if (dist == "sorted") {
+        parallel_generate(pool, out, n, s, [n](Xoshiro256&, size_t i) { return ramp(i, n); });
+    } else if (dist == "reversed") {
+        parallel_generate(pool, out, n, s, [n](Xoshiro256&, size_t i) { return ramp(n - 1 - i, n); });
+    } else if (dist == "few_unique") {
+        UniformInt<int> pick(0, 15);
+        parallel_generate(pool, out, n, s, [pick](Xoshiro256& g) { return pick(g) * 1000003; });
+    } else if (dist == "zipf") {
+        // 100 万种取值，第 r 名出现的概率 ∝ 1/r
+        parallel_generate(pool, out, n, s, Zipf<int>(1000000, 1.0));
+    } else if (dist == "organ_pipe") {
+        parallel_generate(pool, out, n, s, [n](Xoshiro256&, size_t i) { return static_cast<int>(i < n / 2 ? i : n - i); });
+    } else if (dist == "nearly_sorted") {
+        // 升序，其中约 1% 的位置换成随便一个位置上的值
+        UniformInt<size_t> pos(0, n == 0 ? 0 : n - 1);
+        parallel_generate(pool, out, n, s, [n, pos](Xoshiro256& g, size_t i) {
+            return g() % 100 == 0 ? ramp(pos(g), n) : ramp(i, n);
+        });
+    } else {
+        throw std::invalid_argument("未知分布: " + dist);
+    }
+    return v;
+}
+
+// =========================
+// 排序变体
+// =========================
+
+std::vector<Algo> all_algos() {
+    std::vector<Algo> algos;
+    algos.push_back({"std_sort", false, 1, [](WorkStealingPool*, std::vector<int>& v, std::vector<int>&) {
+        std::sort(v.begin(), v.end());
+    }});
+#if defined(CONCURRENCY_STUDY_HAVE_STD_PAR)
+    algos.push_back({"std_par", false, 0, [](WorkStealingPool*, std::vector<int>& v, std::vector<int>&) {
+        std::sort(std::execution::par, v.begin(), v.end());
+    }});
+#endif
+    algos.push_back({"merge_sort", true, 0, [](WorkStealingPool* pool, std::vector<int>& v, std::vector<int>&) {
+        parallel_merge_sort(*pool, v.begin(), v.end());
+    }});
+    algos.push_back({"sample_sort", true, 0, [](WorkStealingPool* pool, std::vector<int>& v, std::vector<int>&) {
+        parallel_sample_sort(*pool, v.begin(), v.end());
+    }});
+    algos.push_back({"radix_sort", true, 0, [](WorkStealingPool* pool, std::vector<int>& v, std::vector<int>&) {
+        parallel_radix_sort(*pool, v.begin(), v.end());
+    }});
+    if (simd_detail::cpu_has_avx2()) {
+        // 单线程的排序网络 + 向量合并（parallel_merge_sort 的叶子就是它）
+        algos.push_back({"network_sort", false, 1, [](WorkStealingPool*, std::vector<int>& v, std::vector<int>& scratch) {
+            if (!simd_sort(v.data(), v.size(), scratch.data())) std::sort(v.begin(), v.end());
+        }, true});
+    }
+    return algos;
+}
+
+// =========================
+// 计时与统计
+// =========================
+
+template<typename Vec>
+uint64_t checksum(const Vec& v) {
+    uint64_t s = 0;
+    for (int x : v) s += static_cast<uint32_t>(x);
+    return s;
+}
+
+Result measure(const Algo& algo, WorkStealingPool* pool, size_t threads, const std::string& dist,
+               const RandomVector<int>& source, uint64_t sum, const Config& cfg) {
+    Result r{algo.name, dist, source.size(), threads, {}, true};
+    std::vector<int> work(source.size());
+    std::vector<int> scratch(algo.needs_scratch ? source.size() : 0);
+    for (size_t w = 0; w < cfg.warmup; ++w) {
+        std::copy(source.begin(), source.end(), work.begin());
+        algo.run(pool, work, scratch);
+    }
+    for (size_t rep = 0; rep < cfg.reps; ++rep) {
+        std::copy(source.begin(), source.end(), work.begin());
+        auto start = Clock::now();
+        algo.run(pool, work, scratch);
+        r.ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        r.ok = r.ok && std::is_sorted(work.begin(), work.end()) && checksum(work) == sum;
+    }
+    std::sort(r.ms.begin(), r.ms.end());
+    return r;
+}
+
+// 线性插值的百分位，q ∈ [0, 1]；ms 已排好序
+double percentile(const std::vector<double>& ms, double q) {
+    double pos = q * static_cast<double>(ms.size() - 1);
+    auto lo = static_cast<size_t>(pos);
+    size_t hi = std::min(lo + 1, ms.size() - 1);
+    return ms[lo] + (ms[hi] - ms[lo]) * (pos - static_cast<double>(lo));
+}
+
+double ns_per_element(const Result& r) {
+    return percentile(r.ms, 0.5) * 1e6 / static_cast<double>(std::max<size_t>(1, r.size));
+}
+
+void write_csv(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "algorithm,distribution,size,threads,reps,min_ms,p10_ms,median_ms,p90_ms,max_ms,ns_per_element,ok\n";
+    out << std::setprecision(6);
+    for (auto& r : results) {
+        out << r.algo << ',' << r.dist << ',' << r.size << ',' << r.threads << ',' << r.ms.size() << ','
+            << r.ms.front() << ',' << percentile(r.ms, 0.1) << ',' << percentile(r.ms, 0.5) << ','
+            << percentile(r.ms, 0.9) << ',' << r.ms.back() << ',' << ns_per_element(r) << ','
+            << (r.ok ? "true" : "false") << '\n';
+    }
+}
+
+void write_json(const std::string& path, const std::vector<Result>& results, const Config& cfg) {
+    std::ofstream out(path);
+    out << std::setprecision(6);
+    out << "{\n  \"config\": {\"seed\": " << cfg.seed << ", \"warmup\": " << cfg.warmup << ", \"reps\": " << cfg.reps
+        << ", \"hardware_concurrency\": " << std::thread::hardware_concurrency()
+        << ", \"avx2\": " << (simd_detail::cpu_has_avx2() ? "true" : "false") << "},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        auto& r = results[i];
+        out << "    {\"algorithm\": \"" << r.algo << "\", \"distribution\": \"" << r.dist << "\", \"size\": " << r.size
+            << ", \"threads\": " << r.threads << ", \"ms\": [";
+        for (size_t k = 0; k < r.ms.size(); ++k) out << (k ? ", " : "") << r.ms[k];
+        out << "], \"median_ms\": " << percentile(r.ms, 0.5) << ", \"p10_ms\": " << percentile(r.ms, 0.1)
+            << ", \"p90_ms\": " << percentile(r.ms, 0.9) << ", \"ns_per_element\": " << ns_per_element(r)
+            << ", \"ok\": " << (r.ok ? "true" : "false") << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    Config cfg;
+    try {
+        if (!parse_args(argc, argv, cfg)) return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "参数错误: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::vector<Algo> algos;
+    for (auto& a : all_algos()) {
+        if (cfg.algos.empty() || std::find(cfg.algos.begin(), cfg.algos.end(), a.name) != cfg.algos.end()) {
+            algos.push_back(std::move(a));
+        }
+    }
+
+    // 每种线程数一个池，整个基准期间常驻（池的创建不计入任何一次计时）
+    std::vector<std::unique_ptr<WorkStealingPool>> pools;
+    for (size_t t : cfg.threads) pools.push_back(std::make_unique<WorkStealingPool>(t));
+
+    std::cout << "核心数 " << std::thread::hardware_concurrency() << "，AVX2 " << (simd_detail::cpu_has_avx2() ? "有" : "无")
+              << "，预热 " << cfg.warmup << " 次，重复 " << cfg.reps << " 次，种子 " << cfg.seed << std::endl;
+    // 表头用 ASCII：setw 按字节数对齐，汉字会把列挤歪
+    std::cout << std::left << std::setw(14) << "algorithm" << std::setw(15) << "distribution" << std::right << std::setw(11)
+              << "size" << std::setw(8) << "threads" << std::setw(12) << "median_ms" << std::setw(12) << "p10_ms"
+              << std::setw(12) << "p90_ms" << std::setw(10) << "ns/elem" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    std::vector<Result> results;
+    auto report = [&](const Result& r) {
+        std::cout << std::left << std::setw(14) << r.algo << std::setw(15) << r.dist << std::right << std::setw(11) << r.size
+                  << std::setw(8) << r.threads << std::setw(12) << percentile(r.ms, 0.5) << std::setw(12)
+                  << percentile(r.ms, 0.1) << std::setw(12) << percentile(r.ms, 0.9) << std::setw(10)
+                  << ns_per_element(r) << (r.ok ? "" : "  结果不对!") << std::endl;
+        results.push_back(r);
+    };
+
+    for (size_t n : cfg.sizes) {
+        for (auto& dist : cfg.dists) {
+            RandomVector<int> source;
+            try {
+                source = make_input(default_work_stealing_pool(), dist, n, cfg.seed);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << std::endl;
+                continue;
+            }
+            uint64_t sum = checksum(source);
+            for (auto& algo : algos) {
+                if (!algo.parallel) {
+                    report(measure(algo, nullptr, algo.fixed_threads, dist, source, sum, cfg));
+                    continue;
+                }
+                for (size_t i = 0; i < pools.size(); ++i) {
+                    report(measure(algo, pools[i].get(), cfg.threads[i], dist, source, sum, cfg));
+                }
+            }
+        }
+    }
+
+    if (!cfg.csv.empty()) write_csv(cfg.csv, results);
+    if (!cfg.json.empty()) write_json(cfg.json, results, cfg);
+    bool all_ok = std::all_of(results.begin(), results.end(), [](const Result& r) { return r.ok; });
+    return all_ok ? 0 : 2;
+}
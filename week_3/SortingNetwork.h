@@ -0,0 +1,340 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_SORTINGNETWORK_H
+#define CONCURRENCY_STUDY_SORTINGNETWORK_H
+
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CONCURRENCY_STUDY_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// =========================
+// 排序网络叶子内核 (AVX2)
+// 归并排序的叶子（几千到几十万个元素）原来交给 std::sort：快排的每次比较都是一个猜不准的分支，
+// 随机数据上大约一半猜错。这里换成比较顺序固定的双调排序网络，比较结果用 min/max 直接算，没有分支：
+//   1. 8 个寄存器一组（int32/float 64 个元素，int64 32 个），先寄存器内排序，再成对做双调合并
+//   2. 有序块之间用向量化的流式合并：每次从两路里头元素更小的那路取一个寄存器，和手里的寄存器做一次双调合并
+// 运行时检测 CPU：没有 AVX2（或者不是 x86）就返回 false，调用者退回 std::sort
+// 只编译这几个函数用 AVX2（GCC/Clang 的 target 属性），整个程序不需要 -mavx2
+// 只处理 int32 / float / int64 的默认升序；float 里有 NaN 时结果未定义（std::sort 也一样）
+// =========================
+
+#if defined(CONCURRENCY_STUDY_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+#define CONCURRENCY_STUDY_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CONCURRENCY_STUDY_TARGET_AVX2
+#endif
+
+namespace simd_detail {
+
+inline bool cpu_has_avx2() {
+#if defined(CONCURRENCY_STUDY_X86_SIMD) && (defined(__GNUC__) || defined(__clang__))
+    static const bool has = __builtin_cpu_supports("avx2");
+    return has;
+#elif defined(CONCURRENCY_STUDY_X86_SIMD) && defined(_MSC_VER)
+    static const bool has = []() {
+        int info[4];
+        __cpuid(info, 1);
+        bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6; // OSXSAVE + YMM 状态
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+    }();
+    return has;
+#else
+    return false;
+#endif
+}
+
+#if defined(CONCURRENCY_STUDY_X86_SIMD)
+
+// 网络里的一步：每个通道和 partner 比较交换，mask 为 -1 的通道留大的那个
+// 都按 32 位字描述，int64 的一个通道占两个字
+struct Step {
+    int32_t idx[8];
+    int32_t mask[8];
+};
+
+// 双调网络的一步：距离 j，块大小 k（k = 0 表示整段升序，用在清理阶段）
+constexpr Step make_step(size_t lanes, size_t j, size_t k) {
+    Step s{};
+    size_t words = 8 / lanes;
+    for (size_t i = 0; i < lanes; ++i) {
+        size_t partner = i ^ j;
+        bool ascending = k == 0 || (i & k) == 0;
+        bool take_max = ascending == (i > partner);
+        for (size_t w = 0; w < words; ++w) {
+            s.idx[i * words + w] = static_cast<int32_t>(partner * words + w);
+            s.mask[i * words + w] = take_max ? -1 : 0;
+        }
+    }
+    return s;
+}
+
+constexpr Step make_reverse(size_t lanes) {
+    Step s{};
+    size_t words = 8 / lanes;
+    for (size_t i = 0; i < lanes; ++i) {
+        for (size_t w = 0; w < words; ++w) s.idx[i * words + w] = static_cast<int32_t>((lanes - 1 - i) * words + w);
+    }
+    return s;
+}
+
+// 寄存器内排序的全部步骤（lanes = 8 时 6 步，4 时 3 步）和清理（已是双调序列 → 升序）的步骤
+template<size_t Lanes>
+struct Network {
+    static constexpr size_t kLogLanes = Lanes == 8 ? 3 : 2;
+    static constexpr size_t kSortSteps = kLogLanes * (kLogLanes + 1) / 2;
+
+    struct Tables {
+        Step sort[kSortSteps];
+        Step clean[kLogLanes];
+        Step reverse;
+    };
+
+    static constexpr Tables make() {
+        Tables t{};
+        size_t n = 0;
+        for (size_t k = 2; k <= Lanes; k *= 2) {
+            for (size_t j = k / 2; j >= 1; j /= 2) t.sort[n++] = make_step(Lanes, j, k);
+        }
+        n = 0;
+        for (size_t j = Lanes / 2; j >= 1; j /= 2) t.clean[n++] = make_step(Lanes, j, 0);
+        t.reverse = make_reverse(Lanes);
+        return t;
+    }
+
+    static constexpr Tables kTables = make();
+};
+
+// 每种元素类型一个寄存器封装：load/store/min/max/permute/blend
+struct Int32x8 {
+    using T = int32_t;
+    using Reg = __m256i;
+    static constexpr size_t kLanes = 8;
+
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static void store(T* p, Reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg min(Reg a, Reg b) { return _mm256_min_epi32(a, b); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg max(Reg a, Reg b) { return _mm256_max_epi32(a, b); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg permute(Reg v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg blend(Reg a, Reg b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+};
+
+struct Float32x8 {
+    using T = float;
+    using Reg = __m256;
+    static constexpr size_t kLanes = 8;
+
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg load(const T* p) { return _mm256_loadu_ps(p); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static void store(T* p, Reg v) { _mm256_storeu_ps(p, v); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg permute(Reg v, __m256i idx) { return _mm256_permutevar8x32_ps(v, idx); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg blend(Reg a, Reg b, __m256i mask) {
+        return _mm256_blendv_ps(a, b, _mm256_castsi256_ps(mask));
+    }
+};
+
+// AVX2 没有 64 位的 min/max：用 cmpgt + blend 拼
+struct Int64x4 {
+    using T = int64_t;
+    using Reg = __m256i;
+    static constexpr size_t kLanes = 4;
+
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg load(const T* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static void store(T* p, Reg v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg min(Reg a, Reg b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg max(Reg a, Reg b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg permute(Reg v, __m256i idx) { return _mm256_permutevar8x32_epi32(v, idx); }
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg blend(Reg a, Reg b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+};
+
+template<typename V>
+struct Kernels {
+    using T = typename V::T;
+    using Reg = typename V::Reg;
+    using Net = Network<V::kLanes>;
+    static constexpr size_t kLanes = V::kLanes;
+    static constexpr size_t kBlockRegs = 8;
+    static constexpr size_t kBlock = kBlockRegs * kLanes; // 一组寄存器排的元素数
+
+    CONCURRENCY_STUDY_TARGET_AVX2 static __m256i load_idx(const int32_t* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg apply(Reg v, const Step& s) {
+        Reg partner = V::permute(v, load_idx(s.idx));
+        return V::blend(V::min(v, partner), V::max(v, partner), load_idx(s.mask));
+    }
+
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg sort_register(Reg v) {
+        for (const Step& s : Net::kTables.sort) v = apply(v, s);
+        return v;
+    }
+
+    // 寄存器里是双调序列 → 升序
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg clean_register(Reg v) {
+        for (const Step& s : Net::kTables.clean) v = apply(v, s);
+        return v;
+    }
+
+    CONCURRENCY_STUDY_TARGET_AVX2 static Reg reverse(Reg v) { return V::permute(v, load_idx(Net::kTables.reverse.idx)); }
+
+    // r[0, count) 前一半、后一半各自有序 → 整体有序：后一半倒过来拼成双调序列，再逐级半清理
+    CONCURRENCY_STUDY_TARGET_AVX2 static void merge_registers(Reg* r, size_t count) {
+        size_t half = count / 2;
+        for (size_t i = 0; i < half / 2; ++i) std::swap(r[half + i], r[count - 1 - i]);
+        for (size_t i = half; i < count; ++i) r[i] = reverse(r[i]);
+        for (size_t d = half; d >= 1; d /= 2) {
+            for (size_t i = 0; i < count; ++i) {
+                if ((i & d) != 0) continue;
+                Reg lo = V::min(r[i], r[i + d]);
+                Reg hi = V::max(r[i], r[i + d]);
+                r[i] = lo;
+                r[i + d] = hi;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) r[i] = clean_register(r[i]);
+    }
+
+    // 排好 src 里的 kBlock 个元素，写到 dst
+    CONCURRENCY_STUDY_TARGET_AVX2 static void sort_block(const T* src, T* dst) {
+        Reg r[kBlockRegs];
+        for (size_t i = 0; i < kBlockRegs; ++i) r[i] = sort_register(V::load(src + i * kLanes));
+        for (size_t width = 2; width <= kBlockRegs; width *= 2) {
+            for (size_t i = 0; i < kBlockRegs; i += width) merge_registers(r + i, width);
+        }
+        for (size_t i = 0; i < kBlockRegs; ++i) V::store(dst + i * kLanes, r[i]);
+    }
+
+    // 流式合并两段有序序列到 out：手里一直拿着一个寄存器，每次从头元素更小的那一路读下一个寄存器，
+    // 两个寄存器做一次双调合并，小的一半写出去。任何一路不足一个寄存器时剩下的标量收尾
+    CONCURRENCY_STUDY_TARGET_AVX2 static void merge_runs(const T* a, size_t m, const T* b, size_t n, T* out) {
+        if (m < kLanes || n < kLanes) {
+            std::merge(a, a + m, b, b + n, out);
+            return;
+        }
+        Reg hi = V::load(a);
+        Reg next = V::load(b);
+        size_t i = kLanes, j = kLanes;
+        while (true) {
+            Reg reversed = reverse(next);
+            Reg lo = clean_register(V::min(hi, reversed));
+            hi = clean_register(V::max(hi, reversed));
+            V::store(out, lo);
+            out += kLanes;
+
+            bool take_a = j >= n || (i < m && !(b[j] < a[i]));
+            if (take_a ? i + kLanes > m : j + kLanes > n) break;
+            if (take_a) {
+                next = V::load(a + i);
+                i += kLanes;
+            } else {
+                next = V::load(b + j);
+                j += kLanes;
+            }
+        }
+
+        // 收尾：手里的寄存器 + 两路剩下的，三路标量合并
+        T held[kLanes];
+        V::store(held, hi);
+        size_t h = 0;
+        while (h < kLanes || i < m || j < n) {
+            if (h < kLanes && (i >= m || !(a[i] < held[h])) && (j >= n || !(b[j] < held[h]))) {
+                *out++ = held[h++];
+            } else if (i < m && (j >= n || !(b[j] < a[i]))) {
+                *out++ = a[i++];
+            } else {
+                *out++ = b[j++];
+            }
+        }
+    }
+
+    // 整段排序：先按 kBlock 一组用网络排好，再两两流式合并，data / scratch 轮流当目的地；
+    // 按合并趟数的奇偶决定第一步写到哪边，保证最后结果落在 data
+    CONCURRENCY_STUDY_TARGET_AVX2 static void sort(T* data, size_t n, T* scratch) {
+        size_t runs = (n + kBlock - 1) / kBlock;
+        size_t passes = 0;
+        for (size_t r = 1; r < runs; r *= 2) ++passes;
+
+        T* from = (passes % 2 == 1) ? scratch : data;
+        T* to = (from == data) ? scratch : data;
+        for (size_t s = 0; s < n; s += kBlock) {
+            if (s + kBlock <= n) {
+                sort_block(data + s, from + s);
+            } else {
+                if (from != data) std::memcpy(from + s, data + s, sizeof(T) * (n - s));
+                std::sort(from + s, from + n);
+            }
+        }
+        for (size_t width = kBlock; width < n; width *= 2) {
+            for (size_t s = 0; s < n; s += 2 * width) {
+                size_t mid = std::min(n, s + width), end = std::min(n, s + 2 * width);
+                if (mid == end) {
+                    std::memcpy(to + s, from + s, sizeof(T) * (end - s));
+                } else {
+                    merge_runs(from + s, mid - s, from + mid, end - mid, to + s);
+                }
+            }
+            std::swap(from, to);
+        }
+    }
+};
+
+#endif // CONCURRENCY_STUDY_X86_SIMD
+
+// 哪些 (迭代器, 元素, 比较器) 组合能走向量内核：连续存储 + int32/float/int64 + 默认升序
+template<typename T>
+constexpr bool kSimdElement = std::is_same_v<T, int32_t> || std::is_same_v<T, float> || std::is_same_v<T, int64_t>;
+
+// 能放心地用 &*begin 当成 T* 连续访问的迭代器（std::deque 之类的分段存储不行）
+template<typename RandomIt, typename T>
+constexpr bool kContiguous = std::is_same_v<RandomIt, T*> || std::is_same_v<RandomIt, typename std::vector<T>::iterator>;
+
+template<typename RandomIt, typename T, typename Compare>
+constexpr bool kSimdEligible = kSimdElement<T> &&
+                               (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<T>>) &&
+                               kContiguous<RandomIt, T>;
+
+} // namespace simd_detail
+
+// =========================
+// simd_sort(data, n, scratch)
+// 用排序网络 + 向量合并把 data[0, n) 升序排好（scratch 至少 n 个元素，内容会被覆盖）
+// 返回 false 表示这台机器 / 这个类型用不了，什么都没做，调用者自己 std::sort
+// =========================
+template<typename T>
+bool simd_sort(T* data, size_t n, T* scratch) {
+#if defined(CONCURRENCY_STUDY_X86_SIMD)
+    if constexpr (simd_detail::kSimdElement<T>) {
+        if (!simd_detail::cpu_has_avx2()) return false;
+        if constexpr (std::is_same_v<T, int32_t>) {
+            simd_detail::Kernels<simd_detail::Int32x8>::sort(data, n, scratch);
+        } else if constexpr (std::is_same_v<T, float>) {
+            simd_detail::Kernels<simd_detail::Float32x8>::sort(data, n, scratch);
+        } else {
+            simd_detail::Kernels<simd_detail::Int64x4>::sort(data, n, scratch);
+        }
+        return true;
+    }
+#endif
+    (void)data;
+    (void)n;
+    (void)scratch;
+    return false;
+}
+
+#endif //CONCURRENCY_STUDY_SORTINGNETWORK_H
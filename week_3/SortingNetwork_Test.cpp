@@ -0,0 +1,89 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <cstdint>
+#include "SortingNetwork.h"
+#include "ParallelSort.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// 叶子大小的块反复排：总共排 total 个元素，返回每个元素的纳秒数
+template<typename T, typename SortFn>
+double ns_per_element(const std::vector<T>& source, size_t block, SortFn sort_fn, bool& ok) {
+    std::vector<T> data = source, scratch(block);
+    auto start = Clock::now();
+    for (size_t s = 0; s + block <= data.size(); s += block) sort_fn(data.data() + s, block, scratch.data());
+    double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    for (size_t s = 0; s + block <= data.size(); s += block) {
+        ok = ok && std::is_sorted(data.begin() + static_cast<std::ptrdiff_t>(s),
+                                  data.begin() + static_cast<std::ptrdiff_t>(s + block));
+    }
+    return ns / static_cast<double>(data.size() / block * block);
+}
+
+template<typename T>
+void leaf_table(const std::string& name, std::mt19937_64& gen) {
+    std::vector<T> source(1 << 22);
+    for (auto& x : source) x = static_cast<T>(static_cast<int64_t>(gen() >> 16) - (int64_t(1) << 47));
+    std::cout << name << std::endl;
+    for (size_t block : {64, 1024, 16384, 262144}) {
+        bool ok = true;
+        double scalar = ns_per_element(source, block, [](T* p, size_t n, T*) { std::sort(p, p + n); }, ok);
+        double simd = ns_per_element(source, block, [](T* p, size_t n, T* s) {
+            if (!simd_sort(p, n, s)) std::sort(p, p + n);
+        }, ok);
+        std::cout << "  块大小 " << std::setw(6) << block << ": std::sort " << std::setw(6) << scalar << " ns/个，排序网络 "
+                  << std::setw(6) << simd << " ns/个 (" << scalar / simd << "x)" << (ok ? "" : " 没排好!") << std::endl;
+    }
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "CPU 支持 AVX2: " << (simd_detail::cpu_has_avx2() ? "是" : "否 (下面都会退回 std::sort)") << std::endl;
+    std::mt19937_64 gen(42);
+
+    // 1. 叶子级别：固定大小的块，每个元素花多少纳秒
+    leaf_table<int32_t>("int32", gen);
+    leaf_table<float>("float", gen);
+    leaf_table<int64_t>("int64", gen);
+
+    // 2. 整体：parallel_merge_sort 的叶子现在走排序网络
+    {
+        const size_t N = 50000000;
+        std::vector<int> source(N);
+        std::uniform_int_distribution<int> dis(1, 1000000000);
+        for (auto& x : source) x = dis(gen);
+
+        std::vector<int> data = source;
+        auto start = Clock::now();
+        std::sort(data.begin(), data.end());
+        double base = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        data = source;
+        start = Clock::now();
+        parallel_merge_sort(data.begin(), data.end());
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << "5000 万 int: std::sort " << base << " ms，parallel_merge_sort " << ms << " ms ("
+                  << base / ms << "x，" << default_work_stealing_pool().thread_count() << " 个工人)"
+                  << (std::is_sorted(data.begin(), data.end()) ? "" : " 没排好!") << std::endl;
+    }
+
+    return 0;
+}
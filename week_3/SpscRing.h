@@ -0,0 +1,259 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_SPSCRING_H
+#define CONCURRENCY_STUDY_SPSCRING_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <new>
+#include <utility>
+#include <cstddef>
+
+// =========================
+// 单生产者单消费者有界环形队列：BoundedBuffer 在“正好一个生产者、一个消费者”时的特化版
+// BoundedBuffer 每次存取都要加锁、通知条件变量；这里生产者只写 tail_、消费者只写 head_，
+// 一次交接只需要一对 acquire/release，没有锁也没有 CAS
+//
+// 几个细节：
+// 1. head_ 和 tail_ 各占一个缓存行，生产者和消费者不会互相把对方的缓存行抢走
+// 2. 缓存对方的下标：生产者记一份 cached_head_，只有“看起来满了”才去读真正的 head_；
+//    消费者同理。大部分操作完全不碰对方的缓存行
+// 3. 批量发布：try_push_n / consume_all 一次搬多个元素，只发布一次下标
+// 4. Blocking = true 时多出 produce / consume / close：先自旋，真的空/满了才睡。
+//    代价是每次发布多一个 seq_cst 栅栏（要检查对方是不是在睡），所以默认关掉
+// =========================
+template<typename T, bool Blocking = false>
+class SpscRing {
+public:
+    // capacity 会向上取到 2 的幂
+    explicit SpscRing(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        mask_ = cap - 1;
+        slots_.reset(new Slot[cap]);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    ~SpscRing() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (; head != tail; ++head) at(head)->~T();
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    // 近似值：另一端可能正在改。先读 head 再读 tail，保证结果不会是负数
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // ---------- 生产者端（只能一个线程调用） ----------
+
+    // 非阻塞放入：满了返回 false。和 SafeQueue::try_produce 一样，只有成功时才移走 value
+    bool try_push(T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (!has_room(tail, 1)) return false;
+        new (at(tail)) T(std::move(value));
+        publish_tail(tail + 1);
+        return true;
+    }
+
+    bool try_push(T&& value) { return try_push(value); }
+
+    // 批量放入：从 first 开始最多移走 n 个，返回实际放入的个数，只发布一次
+    template<typename It>
+    size_t try_push_n(It first, size_t n) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t room = free_slots(tail);
+        if (n > room) n = room;
+        for (size_t i = 0; i < n; ++i, ++first) new (at(tail + i)) T(std::move(*first));
+        if (n > 0) publish_tail(tail + n);
+        return n;
+    }
+
+    // ---------- 消费者端（只能一个线程调用） ----------
+
+    bool try_pop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (!has_items(head, 1)) return false;
+        T* slot = at(head);
+        value = std::move(*slot);
+        slot->~T();
+        publish_head(head + 1);
+        return true;
+    }
+
+    // 批量取出：对当前所有可读的元素（最多 max 个）依次调用 f(T&&)，只发布一次，返回个数
+    template<typename F>
+    size_t consume_all(F&& f, size_t max = static_cast<size_t>(-1)) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t n = ready_items(head);
+        if (n > max) n = max;
+        for (size_t i = 0; i < n; ++i) {
+            T* slot = at(head + i);
+            f(std::move(*slot));
+            slot->~T();
+        }
+        if (n > 0) publish_head(head + n);
+        return n;
+    }
+
+    // ---------- 阻塞接口（Blocking = true 才有） ----------
+
+    // 满了就等；队列关闭后返回 false
+    bool produce(T value) {
+        static_assert(Blocking, "produce() needs SpscRing<T, true>");
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        while (!has_room(tail, 1)) {
+            if (closed_.load(std::memory_order_acquire)) return false;
+            if (!spin_until([this, tail]() { return has_room(tail, 1) || is_closed(); })) {
+                park(producer_waiting_, not_full_, [this, tail]() { return has_room(tail, 1); });
+            }
+        }
+        if (closed_.load(std::memory_order_acquire)) return false;
+        new (at(tail)) T(std::move(value));
+        publish_tail(tail + 1);
+        return true;
+    }
+
+    // 空了就等；队列关闭且已经取空时返回 false（关闭前放进去的元素照样能取到）
+    bool consume(T& value) {
+        static_assert(Blocking, "consume() needs SpscRing<T, true>");
+        size_t head = head_.load(std::memory_order_relaxed);
+        while (!has_items(head, 1)) {
+            if (closed_.load(std::memory_order_acquire)) {
+                if (has_items(head, 1)) break; // 关闭前最后放进来的
+                return false;
+            }
+            if (!spin_until([this, head]() { return has_items(head, 1) || is_closed(); })) {
+                park(consumer_waiting_, not_empty_, [this, head]() { return has_items(head, 1); });
+            }
+        }
+        T* slot = at(head);
+        value = std::move(*slot);
+        slot->~T();
+        publish_head(head + 1);
+        return true;
+    }
+
+    // 关闭：唤醒两端；生产者之后的 produce 都失败，消费者取完剩下的就结束
+    void close() {
+        static_assert(Blocking, "close() needs SpscRing<T, true>");
+        {
+            std::lock_guard<std::mutex> lock(park_mtx_);
+            closed_.store(true, std::memory_order_release);
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    bool is_closed() const { return closed_.load(std::memory_order_acquire); }
+
+private:
+    struct alignas(alignof(T)) Slot {
+        unsigned char bytes[sizeof(T)];
+    };
+
+    T* at(size_t index) { return std::launder(reinterpret_cast<T*>(slots_[index & mask_].bytes)); }
+
+    // 生产者视角：还剩几个空位。先看缓存的 head，不够再去读真的
+    size_t free_slots(size_t tail) {
+        size_t room = capacity() - (tail - cached_head_);
+        if (room == 0) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            room = capacity() - (tail - cached_head_);
+        }
+        return room;
+    }
+
+    bool has_room(size_t tail, size_t n) {
+        if (capacity() - (tail - cached_head_) >= n) return true;
+        cached_head_ = head_.load(std::memory_order_acquire);
+        return capacity() - (tail - cached_head_) >= n;
+    }
+
+    // 消费者视角：有几个可读
+    size_t ready_items(size_t head) {
+        size_t n = cached_tail_ - head;
+        if (n == 0) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            n = cached_tail_ - head;
+        }
+        return n;
+    }
+
+    bool has_items(size_t head, size_t n) {
+        if (cached_tail_ - head >= n) return true;
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        return cached_tail_ - head >= n;
+    }
+
+    void publish_tail(size_t tail) {
+        tail_.store(tail, std::memory_order_release);
+        if constexpr (Blocking) wake_if_waiting(consumer_waiting_, not_empty_);
+    }
+
+    void publish_head(size_t head) {
+        head_.store(head, std::memory_order_release);
+        if constexpr (Blocking) wake_if_waiting(producer_waiting_, not_full_);
+    }
+
+    // 发布方：先发布下标，再看对方是不是要睡了（和 park 里“先声明要睡，再检查一遍”配对）
+    void wake_if_waiting(std::atomic<bool>& waiting, std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiting.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(park_mtx_);
+            cv.notify_one();
+        }
+    }
+
+    // 先自旋一小会儿：对方通常马上就会腾出位置/放进数据，不值得进内核
+    template<typename Pred>
+    static bool spin_until(Pred ready) {
+        for (int i = 0; i < 64; ++i) {
+            if (ready()) return true;
+            if (i >= 16) std::this_thread::yield();
+        }
+        return false;
+    }
+
+    template<typename Pred>
+    void park(std::atomic<bool>& waiting, std::condition_variable& cv, Pred ready) {
+        std::unique_lock<std::mutex> lock(park_mtx_);
+        waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        cv.wait(lock, [&]() { return ready() || closed_.load(std::memory_order_acquire); });
+        waiting.store(false, std::memory_order_relaxed);
+    }
+
+    // 消费者写的：head_ 和它自己的 tail 缓存放在同一个缓存行
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+
+    // 生产者写的
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+
+    // 只读的部分和阻塞用的状态
+    alignas(64) size_t mask_ = 0;
+    std::unique_ptr<Slot[]> slots_;
+
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> producer_waiting_{false};
+    std::atomic<bool> consumer_waiting_{false};
+    std::mutex park_mtx_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
+
+#endif //CONCURRENCY_STUDY_SPSCRING_H
@@ -0,0 +1,129 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include "SpscRing.h"
+#include "SafeQueue.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// 一个生产者把 0..n-1 交给一个消费者，消费者求和校验；返回每秒交接多少个元素（百万）
+template<typename Produce, typename Consume>
+double run_pair(uint64_t n, Produce produce, Consume consume, const char* name) {
+    uint64_t sum = 0;
+    auto start = Clock::now();
+    std::thread consumer([&]() { sum = consume(n); });
+    produce(n);
+    consumer.join();
+    double sec = std::chrono::duration<double>(Clock::now() - start).count();
+
+    uint64_t expect = n * (n - 1) / 2;
+    double mops = static_cast<double>(n) / sec / 1e6;
+    std::cout << name << ": " << mops << " M items/s"
+              << (sum == expect ? "" : "  (校验失败!)") << std::endl;
+    return mops;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    const size_t capacity = 4096;
+
+    // 1. 基准：SafeQueue（和 day_3 的 BoundedBuffer 一样，一把锁 + 两个条件变量）
+    {
+        SafeQueue<uint64_t> q(capacity);
+        run_pair(2000000,
+            [&](uint64_t n) {
+                for (uint64_t i = 0; i < n; ++i) q.produce(i);
+                q.close();
+            },
+            [&](uint64_t) {
+                uint64_t sum = 0, v = 0;
+                while (q.consume(v)) sum += v;
+                return sum;
+            },
+            "SafeQueue (mutex + cv)        ");
+    }
+
+    const uint64_t n = 100000000;
+
+    // 2. SpscRing 逐个 try_push / try_pop，忙等
+    {
+        SpscRing<uint64_t> ring(capacity);
+        run_pair(n,
+            [&](uint64_t total) {
+                for (uint64_t i = 0; i < total; ++i) {
+                    while (!ring.try_push(i)) std::this_thread::yield();
+                }
+            },
+            [&](uint64_t total) {
+                uint64_t sum = 0, v = 0;
+                for (uint64_t got = 0; got < total;) {
+                    if (ring.try_pop(v)) { sum += v; ++got; }
+                    else std::this_thread::yield();
+                }
+                return sum;
+            },
+            "SpscRing 逐个                 ");
+    }
+
+    // 3. SpscRing 批量：生产者攒 256 个一次发布，消费者一次取空
+    {
+        SpscRing<uint64_t> ring(capacity);
+        run_pair(n,
+            [&](uint64_t total) {
+                std::vector<uint64_t> batch(256);
+                for (uint64_t i = 0; i < total;) {
+                    size_t k = 0;
+                    for (; k < batch.size() && i + k < total; ++k) batch[k] = i + k;
+                    size_t sent = 0;
+                    while (sent < k) {
+                        size_t m = ring.try_push_n(batch.begin() + static_cast<std::ptrdiff_t>(sent), k - sent);
+                        if (m == 0) std::this_thread::yield();
+                        sent += m;
+                    }
+                    i += k;
+                }
+            },
+            [&](uint64_t total) {
+                uint64_t sum = 0;
+                for (uint64_t got = 0; got < total;) {
+                    size_t m = ring.consume_all([&sum](uint64_t&& v) { sum += v; });
+                    if (m == 0) std::this_thread::yield();
+                    got += m;
+                }
+                return sum;
+            },
+            "SpscRing 批量                 ");
+    }
+
+    // 4. 阻塞版：produce / consume + close，和 SafeQueue 的用法一样
+    {
+        SpscRing<uint64_t, true> ring(capacity);
+        run_pair(n / 4,
+            [&](uint64_t total) {
+                for (uint64_t i = 0; i < total; ++i) ring.produce(i);
+                ring.close();
+            },
+            [&](uint64_t) {
+                uint64_t sum = 0, v = 0;
+                while (ring.consume(v)) sum += v;
+                return sum;
+            },
+            "SpscRing<T, true> 阻塞        ");
+    }
+
+    return 0;
+}
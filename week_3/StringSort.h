@@ -0,0 +1,302 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_STRINGSORT_H
+#define CONCURRENCY_STUDY_STRINGSORT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+
+#include "ParallelSort.h"
+
+// =========================
+// 并行字符串排序
+// 通用排序每次比较都从第 0 个字符比起：URL、路径这种共享长前缀的键，同一段前缀被反复扫几十遍
+// 这里总的字符访问量大约是“区分前缀”的总长度（每个串和它最像的邻居比到第一个不同的字符为止）：
+//   1. 键先变成 {string_view, 原下标} 的数组，排序期间只搬这 24 字节，不碰 std::string 本身
+//   2. 切成若干块并行排，每块用带缓存的多键快排 (multikey quicksort)：
+//      当前深度起的 7 个字符先取进一个连续的 uint64 缓存数组，三路划分只在缓存上比（串本身散在堆上，每层只碰一次），
+//      小于 / 大于段深度不变、缓存继续有效，只有等于段才往后走
+//   3. 每块排完算出 LCP 数组（和前一个串的公共前缀长度），再两两做 LCP 归并：
+//      两个队头和“上一个输出”的 LCP 不同时不用看字符就知道谁小，相同时才从这个 LCP 处接着比；
+//      每次归并按协同秩切成多段并行做，和 parallel_merge 一样
+//   4. 最后按排好的下标把原来的字符串并行搬到位
+// 顺序：按字节（unsigned char）字典序，和 std::string 的 operator< 一致
+// =========================
+
+namespace string_detail {
+
+struct Item {
+    std::string_view key;
+    size_t index;
+};
+
+// 从第 d 个字符起取 7 个字节拼成一个整数：高 56 位按大端放字符（不足补 0），最低字节放 min(剩余长度, 7)
+// 这样整数的大小顺序 == 从第 d 个字符起的字典序（短的前缀排前面，内嵌的 '\0' 也分得开）；
+// 两个整数相等且最低字节是 7 时才需要往后看，否则两个串已经完全相等
+constexpr size_t kCacheChars = 7;
+
+inline uint64_t chars_at(const Item& x, size_t d) {
+    size_t rem = x.key.size() - d;
+    size_t take = std::min(rem, kCacheChars);
+    uint64_t w = 0;
+    for (size_t k = 0; k < take; ++k) w |= uint64_t(static_cast<unsigned char>(x.key[d + k])) << (56 - 8 * k);
+    return w | take;
+}
+
+// 从 from 开始往后找第一个不同的位置（前 from 个字符已知相同）；先 8 字节一比
+inline size_t lcp_from(std::string_view a, std::string_view b, size_t from) {
+    size_t n = std::min(a.size(), b.size());
+    while (from + 8 <= n) {
+        uint64_t x, y;
+        std::memcpy(&x, a.data() + from, 8);
+        std::memcpy(&y, b.data() + from, 8);
+        if (x != y) break;
+        from += 8;
+    }
+    while (from < n && a[from] == b[from]) ++from;
+    return from;
+}
+
+// 已知前 depth 个字符相同，a 是否严格小于 b
+inline bool less_from(const Item& a, const Item& b, size_t depth) {
+    return a.key.substr(depth) < b.key.substr(depth);
+}
+
+constexpr size_t kInsertion = 16;
+
+// 带缓存的多键快排：a[0, n) 里所有串的前 depth 个字符都相同；cache 和 a 一一对应
+// 每层比 7 个字符：小于 / 大于段深度不变、缓存继续有效，只有等于段往后走 7 个字符、重取缓存
+// 小于 / 大于段递归，等于段循环（串再长也不会把栈压深）
+// NOLINTNEXTLINE(misc-no-recursion)
+inline void multikey_sort(Item* a, uint64_t* cache, size_t n, size_t depth, bool cached) {
+    while (n > kInsertion) {
+        if (!cached) {
+            for (size_t i = 0; i < n; ++i) {
+                // 串散在堆上，每取一个几乎都是缓存未命中：提前 16 个发出预取，让未命中重叠起来
+#if defined(__GNUC__) || defined(__clang__)
+                if (i + 16 < n) __builtin_prefetch(a[i + 16].key.data() + depth);
+#endif
+                cache[i] = chars_at(a[i], depth);
+            }
+        }
+
+        // 三数取中选枢轴
+        uint64_t x = cache[0], y = cache[n / 2], z = cache[n - 1];
+        uint64_t pivot = std::max(std::min(x, y), std::min(std::max(x, y), z));
+
+        // Dijkstra 三路划分：[0, lt) 小于，[lt, i) 等于，[gt, n) 大于
+        size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            if (cache[i] < pivot) {
+                std::swap(cache[i], cache[lt]);
+                std::swap(a[i++], a[lt++]);
+            } else if (cache[i] > pivot) {
+                --gt;
+                std::swap(cache[i], cache[gt]);
+                std::swap(a[i], a[gt]);
+            } else {
+                ++i;
+            }
+        }
+        multikey_sort(a, cache, lt, depth, true);
+        multikey_sort(a + gt, cache + gt, n - gt, depth, true);
+        if ((pivot & 0xFF) != kCacheChars) return; // 等于段的串都在这 7 个字符里结束了：全部相等
+
+        a += lt;
+        cache += lt;
+        n = gt - lt;
+        depth += kCacheChars;
+        cached = false;
+    }
+    for (size_t i = 1; i < n; ++i) {
+        Item v = a[i];
+        size_t j = i;
+        for (; j > 0 && less_from(v, a[j - 1], depth); --j) a[j] = a[j - 1];
+        a[j] = v;
+    }
+}
+
+// 两个有序段的 LCP 归并。la[i] = lcp(a[i-1], a[i])（la[0] 不用），lb 同理；输出的 lout 也是这个含义
+// ha / hb：两个队头各自和“上一个输出”的 LCP。上一个输出不大于两个队头，所以
+//   ha > hb 时 a 在第 hb 个字符上和上一个输出相同、b 在这里更大 → a < b，一个字符都不用比
+// 相等时 a 先出（和 co_rank 的约定一致）
+inline void lcp_merge(const Item* a, const size_t* la, size_t m, const Item* b, const size_t* lb, size_t n,
+                      Item* out, size_t* lout) {
+    size_t i = 0, j = 0, k = 0, ha = 0, hb = 0;
+    while (i < m && j < n) {
+        if (ha > hb) {
+            out[k] = a[i];
+            lout[k++] = ha;
+            ha = ++i < m ? la[i] : 0;
+        } else if (ha < hb) {
+            out[k] = b[j];
+            lout[k++] = hb;
+            hb = ++j < n ? lb[j] : 0;
+        } else {
+            std::string_view x = a[i].key, y = b[j].key;
+            size_t h = lcp_from(x, y, ha);
+            bool a_first = h == x.size() || (h < y.size() && static_cast<unsigned char>(x[h]) < static_cast<unsigned char>(y[h]));
+            if (a_first) {
+                out[k] = a[i];
+                lout[k++] = ha;
+                hb = h;
+                ha = ++i < m ? la[i] : 0;
+            } else {
+                out[k] = b[j];
+                lout[k++] = hb;
+                ha = h;
+                hb = ++j < n ? lb[j] : 0;
+            }
+        }
+    }
+    for (size_t first = i; i < m; ++i, ++k) {
+        out[k] = a[i];
+        lout[k] = i == first ? ha : la[i];
+    }
+    for (size_t first = j; j < n; ++j, ++k) {
+        out[k] = b[j];
+        lout[k] = j == first ? hb : lb[j];
+    }
+}
+
+// 把 src 里相邻的两段 [lo, mid) [mid, hi) 归并到 dst 的 [lo, hi)：按协同秩切成多段并行，
+// 每段开头的 LCP 是按“没有上一个输出”算的，最后单独补算
+inline void merge_pair(WorkStealingPool& pool, const Item* src, const size_t* lsrc, Item* dst, size_t* ldst,
+                       size_t lo, size_t mid, size_t hi, size_t grain) {
+    size_t m = mid - lo, n = hi - mid, total = hi - lo;
+    size_t parts = std::max<size_t>(1, total / grain);
+    auto less = [](const Item& x, const Item& y) { return x.key < y.key; };
+    auto part = [&](size_t p) {
+        size_t k0 = total * p / parts, k1 = total * (p + 1) / parts;
+        size_t i0 = sort_detail::co_rank(k0, src + lo, m, src + mid, n, less);
+        size_t i1 = sort_detail::co_rank(k1, src + lo, m, src + mid, n, less);
+        lcp_merge(src + lo + i0, lsrc + lo + i0, i1 - i0, src + mid + (k0 - i0), lsrc + mid + (k0 - i0),
+                  (k1 - i1) - (k0 - i0), dst + lo + k0, ldst + lo + k0);
+    };
+    sort_detail::fork_each(pool, 0, parts, part);
+    for (size_t p = 1; p < parts; ++p) {
+        size_t k = lo + total * p / parts;
+        ldst[k] = lcp_from(dst[k - 1].key, dst[k].key, 0);
+    }
+}
+
+inline void sort_items(WorkStealingPool& pool, Item* items, size_t n) {
+    size_t blocks = std::max<size_t>(1, std::min(pool.thread_count() * 2, n / 8192));
+    std::vector<size_t> bound(blocks + 1);
+    for (size_t b = 0; b <= blocks; ++b) bound[b] = n * b / blocks;
+
+    // 每块：多键快排 + LCP 数组
+    // 缓冲都用 ScratchBuffer：整数数组不初始化，第一次写在各块的工人上，缺页也摊开
+    sort_detail::ScratchBuffer<size_t> lcp(pool, blocks > 1 ? n : 0, static_cast<const size_t*>(nullptr));
+    {
+        sort_detail::ScratchBuffer<uint64_t> cache(pool, n, static_cast<const uint64_t*>(nullptr));
+        auto leaf = [&](size_t b) {
+            size_t lo = bound[b], hi = bound[b + 1];
+            multikey_sort(items + lo, cache.data() + lo, hi - lo, 0, false);
+            if (blocks == 1) return; // 只有一块就不用归并，也不用 LCP
+            if (lo < hi) lcp[lo] = 0;
+            for (size_t i = lo + 1; i < hi; ++i) lcp[i] = lcp_from(items[i - 1].key, items[i].key, 0);
+        };
+        sort_detail::fork_each(pool, 0, blocks, leaf);
+    } // 缓存到这里就用完了，归并之前先还掉
+    if (blocks == 1) return;
+
+    // 逐层两两 LCP 归并，items / scratch 乒乓；落单的一段原样拷过去（当成和空段归并）
+    sort_detail::ScratchBuffer<Item> scratch(pool, n, items);
+    sort_detail::ScratchBuffer<size_t> lcp_scratch(pool, n, static_cast<const size_t*>(nullptr));
+    Item* src = items;
+    Item* dst = scratch.data();
+    size_t* lsrc = lcp.data();
+    size_t* ldst = lcp_scratch.data();
+    size_t grain = sort_detail::auto_grain(n, pool.thread_count());
+    while (bound.size() > 2) {
+        size_t pairs = bound.size() / 2; // 段数 = bound.size() - 1
+        auto merge = [&](size_t p) {
+            size_t lo = bound[2 * p], mid = bound[std::min(2 * p + 1, bound.size() - 1)];
+            size_t hi = bound[std::min(2 * p + 2, bound.size() - 1)];
+            merge_pair(pool, src, lsrc, dst, ldst, lo, mid, hi, grain);
+        };
+        sort_detail::fork_each(pool, 0, pairs, merge);
+        std::vector<size_t> next;
+        for (size_t b = 0; b < bound.size(); b += 2) next.push_back(bound[b]);
+        if (next.back() != n) next.push_back(n);
+        bound.swap(next);
+        std::swap(src, dst);
+        std::swap(lsrc, ldst);
+    }
+    if (src != items) {
+        auto copy_back = [&](size_t p) {
+            size_t lo = n * p / blocks, hi = n * (p + 1) / blocks;
+            std::copy(src + lo, src + hi, items + lo);
+        };
+        sort_detail::fork_each(pool, 0, blocks, copy_back);
+    }
+}
+
+} // namespace string_detail
+
+// =========================
+// parallel_string_sort(pool, begin, end)
+// 对 std::string / std::string_view（或任何能转成 string_view 的类型）的序列按字节字典序原地升序排序
+// 额外占用每个串约 64 字节（下标数组、LCP 数组和它们的乒乓缓冲）外加 n 个元素的搬运缓冲；不稳定，但相等的串本来就分不出来
+// =========================
+template<typename RandomIt>
+void parallel_string_sort(WorkStealingPool& pool, RandomIt begin, RandomIt end) {
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+    using D = std::ptrdiff_t;
+    static_assert(std::is_convertible_v<const T&, std::string_view>, "parallel_string_sort 的元素必须能转成 std::string_view");
+    auto n = static_cast<size_t>(std::distance(begin, end));
+    if (n < 2) return;
+
+    sort_detail::ScratchBuffer<string_detail::Item> items(pool, n, static_cast<const string_detail::Item*>(nullptr));
+    pool.run([&]() {
+        size_t blocks = std::max<size_t>(1, std::min(pool.thread_count() * 2, n / 8192));
+        auto block_lo = [&](size_t b) { return n * b / blocks; };
+        auto fill = [&](size_t b) {
+            for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) {
+                items[i] = string_detail::Item{std::string_view(begin[static_cast<D>(i)]), i};
+            }
+        };
+        sort_detail::fork_each(pool, 0, blocks, fill);
+
+        string_detail::sort_items(pool, items.data(), n);
+
+        // 按下标把原串搬进临时区，再搬回来（std::string 的移动只是交换指针）
+        // 临时区是原始内存：每个位置恰好被 gather 移动构造一次、被 put_back 搬走并析构一次，
+        // 不用先串行默认构造 n 个对象，缺页也摊在各工人上
+        std::allocator<T> alloc;
+        T* moved = alloc.allocate(n);
+        auto gather = [&](size_t b) {
+            for (size_t i = block_lo(b), e = block_lo(b + 1); i < e; ++i) {
+                ::new (static_cast<void*>(moved + i)) T(std::move(begin[static_cast<D>(items[i].index)]));
+            }
+        };
+        sort_detail::fork_each(pool, 0, blocks, gather);
+        auto put_back = [&](size_t b) {
+            std::move(moved + block_lo(b), moved + block_lo(b + 1), begin + static_cast<D>(block_lo(b)));
+            std::destroy(moved + block_lo(b), moved + block_lo(b + 1));
+        };
+        sort_detail::fork_each(pool, 0, blocks, put_back);
+        alloc.deallocate(moved, n);
+    });
+}
+
+// 用默认工作窃取池
+template<typename RandomIt>
+void parallel_string_sort(RandomIt begin, RandomIt end) {
+    parallel_string_sort(default_work_stealing_pool(), begin, end);
+}
+
+#endif //CONCURRENCY_STUDY_STRINGSORT_H
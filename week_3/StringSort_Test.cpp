@@ -0,0 +1,118 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include "StringSort.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// URL 样的键：几个站点 × 几种路径模板，前缀很长、只有最后几段不同
+std::vector<std::string> make_urls(size_t n, std::mt19937_64& gen) {
+    const char* hosts[] = {"https://www.example.com", "https://api.example.com", "https://static.example-cdn.net"};
+    const char* paths[] = {"/api/v2/users/", "/api/v2/orders/", "/assets/images/products/thumbnails/", "/docs/guide/"};
+    std::vector<std::string> v;
+    v.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        std::string s = hosts[gen() % 3];
+        s += paths[gen() % 4];
+        s += std::to_string(gen() % 1000000);
+        s += "/item/";
+        s += std::to_string(gen() % 1000);
+        v.push_back(std::move(s));
+    }
+    return v;
+}
+
+// 排好序的数组里：每个串的区分前缀 = 和前后邻居的最大 LCP + 1（不超过串长）
+void prefix_stats(const std::vector<std::string>& sorted) {
+    double total_len = 0, distinguishing = 0;
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        auto lcp = [&](size_t a, size_t b) {
+            size_t k = 0, m = std::min(sorted[a].size(), sorted[b].size());
+            while (k < m && sorted[a][k] == sorted[b][k]) ++k;
+            return k;
+        };
+        size_t h = 0;
+        if (i > 0) h = std::max(h, lcp(i - 1, i));
+        if (i + 1 < sorted.size()) h = std::max(h, lcp(i, i + 1));
+        total_len += static_cast<double>(sorted[i].size());
+        distinguishing += static_cast<double>(std::min(h + 1, sorted[i].size()));
+    }
+    std::cout << "平均长度 " << total_len / static_cast<double>(sorted.size()) << " 字节，平均区分前缀 "
+              << distinguishing / static_cast<double>(sorted.size()) << " 字节" << std::endl;
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    std::cout << std::fixed << std::setprecision(1);
+    WorkStealingPool& pool = default_work_stealing_pool();
+    std::cout << "工人数: " << pool.thread_count() << std::endl;
+    std::mt19937_64 gen(42);
+
+    // 1. 500 万个 URL
+    const size_t N = 5000000;
+    std::vector<std::string> source = make_urls(N, gen);
+
+    std::vector<std::string> expect = source;
+    auto start = Clock::now();
+    std::sort(expect.begin(), expect.end());
+    double base = ms_since(start);
+    prefix_stats(expect);
+
+    std::vector<std::string> data = source;
+    start = Clock::now();
+    parallel_merge_sort(pool, data.begin(), data.end());
+    double merge = ms_since(start);
+    bool merge_ok = data == expect;
+
+    data = source;
+    start = Clock::now();
+    parallel_string_sort(pool, data.begin(), data.end());
+    double str = ms_since(start);
+    bool str_ok = data == expect;
+
+    std::cout << "500 万 URL: std::sort " << base << " ms，parallel_merge_sort " << merge << " ms，parallel_string_sort "
+              << str << " ms (" << base / str << "x)" << (merge_ok && str_ok ? "" : " 结果不一致!") << std::endl;
+
+    // 2. string_view：只排视图，底下的字符串不动
+    {
+        std::vector<std::string_view> views(source.begin(), source.end());
+        start = Clock::now();
+        parallel_string_sort(pool, views.begin(), views.end());
+        double ms = ms_since(start);
+        bool ok = std::equal(views.begin(), views.end(), expect.begin(), expect.end());
+        std::cout << "500 万 string_view: " << ms << " ms" << (ok ? "" : " 结果不一致!") << std::endl;
+    }
+
+    // 3. 大量重复、互为前缀、空串
+    {
+        std::vector<std::string> v;
+        for (size_t i = 0; i < 200000; ++i) v.push_back(std::string(gen() % 20, "ab"[gen() % 2]));
+        std::vector<std::string> e = v;
+        std::sort(e.begin(), e.end());
+        parallel_string_sort(pool, v.begin(), v.end());
+        std::cout << "重复 / 前缀 / 空串: " << (v == e ? "结果一致" : "结果不一致!") << std::endl;
+    }
+
+    return 0;
+}
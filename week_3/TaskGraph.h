@@ -0,0 +1,212 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_TASKGRAPH_H
+#define CONCURRENCY_STUDY_TASKGRAPH_H
+
+#include <vector>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+
+#include "ThreadPool.h"
+
+// =========================
+// 任务图（DAG）执行器
+// 每个节点一个原子依赖计数，最后一个前驱完成时把它减到 0，
+// 由完成前驱的那个工人直接调度它 —— 没有任何工人会阻塞等前驱
+// 图建好以后可以反复 run()，每次只需把计数复位，拓扑信息不重算
+// =========================
+class TaskGraph {
+public:
+    using NodeId = size_t;
+    using Task = std::function<void()>;
+
+    TaskGraph() = default;
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    NodeId add_node(Task fn) {
+        check_not_running();
+        nodes_.push_back(Node{std::move(fn), {}, 0});
+        compiled_ = false;
+        return nodes_.size() - 1;
+    }
+
+    // from 完成之后 to 才能开始
+    void add_edge(NodeId from, NodeId to) {
+        check_not_running();
+        if (from >= nodes_.size() || to >= nodes_.size() || from == to) {
+            throw std::invalid_argument("TaskGraph: bad edge");
+        }
+        nodes_[from].successors.push_back(to);
+        ++nodes_[to].in_degree;
+        compiled_ = false;
+    }
+
+    size_t size() const { return nodes_.size(); }
+
+    // 启动一次执行（不阻塞）。on_done 在最后一个节点完成的那个线程里、wait() 返回之前调用
+    void run(ThreadPool& pool, std::function<void()> on_done = nullptr) {
+        bool expected = false;
+        if (!running_.compare_exchange_strong(expected, true)) {
+            throw std::logic_error("TaskGraph: already running");
+        }
+        compile();
+
+        {
+            std::lock_guard<std::mutex> lock(done_mtx_);
+            done_ = false;
+        }
+        error_ = nullptr;
+        on_done_ = std::move(on_done);
+        pool_ = &pool;
+
+        // 复位：每个节点的计数回到入度，这是每次运行唯一的 O(n) 准备工作
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            pending_[i].store(nodes_[i].in_degree, std::memory_order_relaxed);
+            poisoned_[i].store(false, std::memory_order_relaxed);
+        }
+        remaining_.store(nodes_.size(), std::memory_order_release);
+
+        if (nodes_.empty()) {
+            finish();
+            return;
+        }
+        for (NodeId root : roots_) {
+            schedule(root);
+        }
+    }
+
+    // 等待本次执行结束（调用者线程阻塞，不要在池子的工人里调用）
+    // 某个节点抛了异常的话，在这里重新抛出（多个节点失败时抛第一个）；
+    // 失败节点的下游（直接或间接）不再执行，和它无关的分支照常跑完
+    void wait() {
+        std::unique_lock<std::mutex> lock(done_mtx_);
+        done_cv_.wait(lock, [this]() { return done_; });
+        if (error_) std::rethrow_exception(error_);
+    }
+
+    void run_and_wait(ThreadPool& pool) {
+        run(pool);
+        wait();
+    }
+
+private:
+    struct Node {
+        Task fn;
+        std::vector<NodeId> successors;
+        size_t in_degree;
+    };
+
+    void check_not_running() const {
+        if (running_.load()) throw std::logic_error("TaskGraph: cannot modify while running");
+    }
+
+    // 第一次运行（或结构改变后）做一次：找根节点、检查环、分配计数数组
+    void compile() {
+        if (compiled_) return;
+
+        roots_.clear();
+        std::vector<size_t> degree(nodes_.size());
+        std::vector<NodeId> order;
+        for (size_t i = 0; i < nodes_.size(); ++i) {
+            degree[i] = nodes_[i].in_degree;
+            if (degree[i] == 0) {
+                roots_.push_back(i);
+                order.push_back(i);
+            }
+        }
+        // Kahn 拓扑排序，只用来检查有没有环
+        for (size_t k = 0; k < order.size(); ++k) {
+            for (NodeId s : nodes_[order[k]].successors) {
+                if (--degree[s] == 0) order.push_back(s);
+            }
+        }
+        if (order.size() != nodes_.size()) {
+            running_.store(false);
+            throw std::invalid_argument("TaskGraph: cycle detected");
+        }
+
+        pending_.reset(new std::atomic<size_t>[nodes_.size()]);
+        poisoned_.reset(new std::atomic<bool>[nodes_.size()]);
+        compiled_ = true;
+    }
+
+    // 交给线程池；队列满了就在当前线程直接跑，保证工人永远不会卡在 enqueue 上
+    void schedule(NodeId id) {
+        if (!pool_->try_enqueue([this, id]() { execute(id); })) {
+            execute(id);
+        }
+    }
+
+    void execute(NodeId id) {
+        while (true) {
+            // 有前驱失败（或被跳过）的节点不执行，只把“中毒”继续传给自己的后继
+            bool poisoned = poisoned_[id].load(std::memory_order_relaxed);
+            if (!poisoned) {
+                try {
+                    if (nodes_[id].fn) nodes_[id].fn();
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(done_mtx_);
+                    if (!error_) error_ = std::current_exception();
+                    poisoned = true;
+                }
+            }
+
+            // 把就绪的后继挑出来：第一个留给自己接着跑（省一次入队），其余的交给线程池
+            // 中毒标记在减计数之前写：减到 0 的那个线程通过 acq_rel 一定能看到所有前驱写的标记
+            NodeId next = kNone;
+            for (NodeId s : nodes_[id].successors) {
+                if (poisoned) poisoned_[s].store(true, std::memory_order_relaxed);
+                if (pending_[s].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    if (next == kNone) next = s;
+                    else schedule(s);
+                }
+            }
+
+            if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                finish();
+                return;
+            }
+            if (next == kNone) return;
+            id = next;
+        }
+    }
+
+    void finish() {
+        std::function<void()> cb = std::move(on_done_);
+        if (cb) cb();
+
+        // 持锁通知：wait() 一返回调用者就可能把图销毁，解锁后不能再碰成员
+        std::lock_guard<std::mutex> lock(done_mtx_);
+        running_.store(false);
+        done_ = true;
+        done_cv_.notify_all();
+    }
+
+    static constexpr NodeId kNone = static_cast<NodeId>(-1);
+
+    std::vector<Node> nodes_;
+    std::vector<NodeId> roots_;
+    std::unique_ptr<std::atomic<size_t>[]> pending_; // 每个节点还差几个前驱
+    std::unique_ptr<std::atomic<bool>[]> poisoned_;  // 有前驱失败或被跳过，本节点不执行
+    bool compiled_ = false;
+
+    ThreadPool* pool_ = nullptr;
+    std::atomic<size_t> remaining_{0}; // 本次运行还没完成的节点数
+    std::atomic<bool> running_{false};
+    std::exception_ptr error_;
+    std::function<void()> on_done_;
+
+    std::mutex done_mtx_;
+    std::condition_variable done_cv_;
+    bool done_ = true;
+};
+
+#endif //CONCURRENCY_STUDY_TASKGRAPH_H
@@ -0,0 +1,102 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <thread>
+#include <stdexcept>
+#include "TaskGraph.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    ThreadPool pool(4);
+
+    // 1. 菱形依赖：parse -> (transform_a, transform_b) -> merge -> write
+    {
+        std::mutex print_mtx;
+        auto log = [&print_mtx](const char* stage) {
+            std::lock_guard<std::mutex> lock(print_mtx);
+            std::cout << "  " << stage << " (线程 " << std::this_thread::get_id() << ")" << std::endl;
+        };
+
+        TaskGraph graph;
+        auto parse = graph.add_node([&] { log("parse"); });
+        auto ta = graph.add_node([&] { log("transform_a"); });
+        auto tb = graph.add_node([&] { log("transform_b"); });
+        auto merge = graph.add_node([&] { log("merge"); });
+        auto write = graph.add_node([&] { log("write"); });
+        graph.add_edge(parse, ta);
+        graph.add_edge(parse, tb);
+        graph.add_edge(ta, merge);
+        graph.add_edge(tb, merge);
+        graph.add_edge(merge, write);
+
+        for (int round = 0; round < 2; ++round) {
+            std::cout << "第 " << round + 1 << " 次运行:" << std::endl;
+            graph.run_and_wait(pool);
+        }
+    }
+
+    // 2. 同一张图反复运行，看每次启动的摊销开销
+    {
+        const int layers = 10, width = 16, runs = 1000;
+        std::atomic<long long> counter{0};
+        TaskGraph graph;
+        std::vector<TaskGraph::NodeId> prev;
+        for (int l = 0; l < layers; ++l) {
+            std::vector<TaskGraph::NodeId> cur;
+            for (int w = 0; w < width; ++w) {
+                auto id = graph.add_node([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+                for (auto p : prev) graph.add_edge(p, id);
+                cur.push_back(id);
+            }
+            prev = cur;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < runs; ++r) graph.run_and_wait(pool);
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "\n" << layers * width << " 个节点的图运行 " << runs << " 次，共执行 "
+                  << counter.load() << " 个节点，平均每次 " << static_cast<double>(us) / runs << " us" << std::endl;
+    }
+
+    // 3. 异常：失败节点的下游（包括间接下游）不会执行，不相干的分支照常执行，wait() 把异常抛回调用者
+    //    a(抛异常) -> b -> c      d -> e（和 a 无关）
+    {
+        TaskGraph graph;
+        std::atomic<int> downstream_ran{0}, independent_ran{0};
+        auto a = graph.add_node([] { throw std::runtime_error("stage failed"); });
+        auto b = graph.add_node([&downstream_ran] { ++downstream_ran; });
+        auto c = graph.add_node([&downstream_ran] { ++downstream_ran; });
+        auto d = graph.add_node([&independent_ran] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20)); // 保证 a 先失败
+            ++independent_ran;
+        });
+        auto e = graph.add_node([&independent_ran] { ++independent_ran; });
+        graph.add_edge(a, b);
+        graph.add_edge(b, c);
+        graph.add_edge(d, e);
+        try {
+            graph.run_and_wait(pool);
+        } catch (const std::exception& ex) {
+            std::cout << "\n捕获异常: " << ex.what() << "，下游执行了 " << downstream_ran.load()
+                      << " / 2 个，无关分支执行了 " << independent_ran.load() << " / 2 个" << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,604 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_THREADPOOL_H
+#define CONCURRENCY_STUDY_THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <map>
+#include <deque>
+#include <memory>
+#include <ostream>
+
+#include "SafeQueue.h"
+#include "CpuTopology.h"
+#include "PoolMetrics.h"
+
+// 队列满时怎么办（只影响 enqueue()；try_enqueue / enqueue_for 有自己的语义）
+enum class OverflowPolicy {
+    Block = 0,      // 阻塞调用者直到有空位（day3_task 的原始行为）
+    Reject = 1,     // 直接拒绝，enqueue 返回 false
+    CallerRuns = 2, // 在调用者线程里直接执行，天然形成反压
+    DropOldest = 3, // 丢掉队列里最老的任务，给新任务腾位置
+    Spill = 4       // 溢出到一个无界的备用队列，工人取完主队列后回填；
+                    // 备用队列非空时新任务也排到它后面，整体仍是先来先执行
+};
+
+// 溢出计数：每种策略触发了多少次
+struct OverflowStats {
+    size_t rejected = 0;    // Reject 策略 + try_enqueue 失败
+    size_t timed_out = 0;   // enqueue_for 超时
+    size_t caller_runs = 0; // CallerRuns 策略在调用者线程执行的次数
+    size_t dropped = 0;     // DropOldest 丢掉的老任务数
+    size_t spilled = 0;     // 进入溢出队列的任务数
+};
+
+// =========================
+// 线程池配置
+// min_threads == max_threads 时就是 day3_task 里的固定大小线程池
+// =========================
+struct ThreadPoolOptions {
+    size_t min_threads = 1;
+    size_t max_threads = 1;
+    size_t queue_capacity = 100;
+    OverflowPolicy overflow_policy = OverflowPolicy::Block;
+
+    // 扩容阈值（满足任意一个就加工人）：
+    // 1. 队列里积压的任务数 >= scale_up_queue_depth（0 表示不看深度）
+    // 2. 任务从入队到开始执行等了 >= scale_up_wait（0 表示不看等待时间）
+    size_t scale_up_queue_depth = 0;
+    std::chrono::milliseconds scale_up_wait{0};
+
+    // 缩容：工人空闲超过这个时间，且线程数多于 min_threads，就退休
+    std::chrono::milliseconds idle_timeout{std::chrono::seconds(30)};
+
+    // CPU 亲和性：为空表示不绑核（操作系统随便调度）
+    // pin_per_core = false：每个工人绑到整个 cpu_set（只防止跨 socket 漂移）
+    // pin_per_core = true ：第 i 个工人绑到 cpu_set[i % size] 这一个核（连 L2 迁移也避免）
+    std::vector<int> cpu_set;
+    bool pin_per_core = false;
+
+    // 埋点：每个任务记录排队等待 / 执行耗时，每个工人记录忙闲时间
+    // 开销是每个任务多一次 steady_clock::now() 和几次单写者计数，可以常开
+    bool enable_metrics = true;
+
+    static ThreadPoolOptions fixed(size_t numThreads) {
+        ThreadPoolOptions opt;
+        opt.min_threads = numThreads;
+        opt.max_threads = numThreads;
+        return opt;
+    }
+
+    static ThreadPoolOptions elastic(size_t minThreads, size_t maxThreads) {
+        ThreadPoolOptions opt;
+        opt.min_threads = minThreads;
+        opt.max_threads = maxThreads < minThreads ? minThreads : maxThreads;
+        opt.scale_up_queue_depth = 1;
+        opt.scale_up_wait = std::chrono::milliseconds(10);
+        opt.idle_timeout = std::chrono::seconds(5);
+        return opt;
+    }
+};
+
+// =========================
+// 安全线程池（可析构，可弹性伸缩）
+// =========================
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    explicit ThreadPool(size_t numThreads)
+            : ThreadPool(ThreadPoolOptions::fixed(numThreads)) {}
+
+    explicit ThreadPool(const ThreadPoolOptions& options)
+            : options_(options),
+              tasks_(options.queue_capacity)
+    {
+        std::lock_guard<std::mutex> lock(workers_mtx_);
+        for (size_t i = 0; i < options_.min_threads; ++i) {
+            spawn_worker_locked();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 提交任务：如果线程池已停止/队列已关闭，会提交失败
+    // 队列满时的行为由 options.overflow_policy 决定
+    bool enqueue(Task task) {
+        if (stop_.load()) return false;
+        TaskItem item{std::move(task), Clock::now()};
+        bool accepted = false;
+        if (spill_behind(item, accepted)) return accepted;
+
+        if (options_.overflow_policy == OverflowPolicy::Block) {
+            if (!tasks_.produce(std::move(item))) return false;
+            // 入队之后看一眼积压情况，必要时加工人
+            maybe_grow(tasks_.size(), Clock::duration::zero());
+            return true;
+        }
+
+        QueueStatus status = tasks_.try_produce(item);
+        if (status == QueueStatus::Ok) {
+            maybe_grow(tasks_.size(), Clock::duration::zero());
+            return true;
+        }
+        if (status == QueueStatus::Closed) return false;
+
+        // 满了：弹性模式下先争取加一个工人，再按策略处理这一个任务
+        maybe_grow(tasks_.capacity(), Clock::duration::zero());
+        return handle_overflow(std::move(item));
+    }
+
+    // 非阻塞提交：队列满了立刻返回 false，绝不卡住调用者（比如网络线程）
+    bool try_enqueue(Task task) {
+        if (stop_.load()) return false;
+        TaskItem item{std::move(task), Clock::now()};
+        bool accepted = false;
+        if (spill_behind(item, accepted)) return accepted;
+
+        QueueStatus status = tasks_.try_produce(item);
+        if (status == QueueStatus::Full) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            maybe_grow(tasks_.capacity(), Clock::duration::zero());
+            return false;
+        }
+        if (status != QueueStatus::Ok) return false;
+
+        maybe_grow(tasks_.size(), Clock::duration::zero());
+        return true;
+    }
+
+    // 限时提交：最多等 timeout，还没空位就返回 false
+    template<typename Rep, typename Period>
+    bool enqueue_for(Task task, const std::chrono::duration<Rep, Period>& timeout) {
+        if (stop_.load()) return false;
+        TaskItem item{std::move(task), Clock::now()};
+        bool accepted = false;
+        if (spill_behind(item, accepted)) return accepted;
+
+        QueueStatus status = tasks_.try_produce(item);
+        if (status == QueueStatus::Full) {
+            maybe_grow(tasks_.capacity(), Clock::duration::zero());
+            status = tasks_.produce_for(item, timeout);
+        }
+        if (status == QueueStatus::Timeout) {
+            timed_out_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (status != QueueStatus::Ok) return false;
+
+        maybe_grow(tasks_.size(), Clock::duration::zero());
+        return true;
+    }
+
+    // 必须执行的提交：给协程恢复、future 回调这类“延续”用，丢了就会有人永远等下去。
+    // 不受 overflow_policy 影响：主队列满了放进无界的溢出队列，由工人回填；也不会被 DropOldest 挤掉。
+    // 从不阻塞，工人线程里调用也安全；只有线程池已经停止时返回 false（调用者应当自己原地执行）
+    bool enqueue_must_run(Task task) {
+        if (stop_.load()) return false;
+        TaskItem item{std::move(task), Clock::now(), true};
+
+        QueueStatus status = tasks_.try_produce(item);
+        if (status == QueueStatus::Closed) return false;
+        if (status == QueueStatus::Full) {
+            maybe_grow(tasks_.capacity(), Clock::duration::zero());
+            std::lock_guard<std::mutex> lock(spill_mtx_);
+            return push_spill_locked(std::move(item));
+        }
+        maybe_grow(tasks_.size(), Clock::duration::zero());
+        return true;
+    }
+
+    OverflowStats overflow_stats() const {
+        OverflowStats s;
+        s.rejected = rejected_.load(std::memory_order_relaxed);
+        s.timed_out = timed_out_.load(std::memory_order_relaxed);
+        s.caller_runs = caller_runs_.load(std::memory_order_relaxed);
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        s.spilled = spilled_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    // 阻塞通知：任务要去做阻塞 IO / 等锁之前调用 begin_blocking()，
+    // 线程池会临时允许多开一个工人来顶替它，避免所有工人都卡住
+    // 只对本池工人、且允许扩容的池子生效：固定大小的池不补人，别的线程调用也不算（begin / end 成对地什么都不做）
+    void begin_blocking() {
+        if (!compensates_blocking()) return;
+        blocked_.fetch_add(1);
+        if (idle_.load() > 0) return; // 还有闲着的工人，不用补
+
+        std::lock_guard<std::mutex> lock(workers_mtx_);
+        if (stop_.load()) return;
+        if (live_.load() < options_.max_threads + blocked_.load()) {
+            spawn_worker_locked();
+        }
+    }
+
+    // 阻塞结束：多出来的工人会在空闲超时后自己退休
+    void end_blocking() {
+        if (!compensates_blocking()) return;
+        blocked_.fetch_sub(1);
+    }
+
+    // RAII 版本：作用域内视为“正在阻塞”
+    class BlockingScope {
+    public:
+        explicit BlockingScope(ThreadPool& pool) : pool_(pool) { pool_.begin_blocking(); }
+        ~BlockingScope() { pool_.end_blocking(); }
+        BlockingScope(const BlockingScope&) = delete;
+        BlockingScope& operator=(const BlockingScope&) = delete;
+    private:
+        ThreadPool& pool_;
+    };
+
+    size_t thread_count() const { return live_.load(); }
+    size_t idle_count() const { return idle_.load(); }
+    size_t blocked_count() const { return blocked_.load(); }
+    size_t queue_size() const { return tasks_.size(); }
+    size_t spill_size() const {
+        std::lock_guard<std::mutex> lock(spill_mtx_);
+        return spill_.size();
+    }
+    const ThreadPoolOptions& options() const { return options_; }
+
+    // 当前线程是不是本线程池的工人：begin_blocking / end_blocking 只认本池工人的阻塞通知
+    bool is_worker_thread() const { return current_pool_ == this; }
+
+    // 埋点快照：每个在职工人的任务数、忙闲时间、等待/执行直方图，已退休的合成一份汇总
+    PoolMetricsSnapshot metrics() {
+        PoolMetricsSnapshot snap;
+        {
+            std::lock_guard<std::mutex> lock(workers_mtx_);
+            for (const auto& kv : worker_stats_) {
+                snap.workers.push_back(snapshot_of(*kv.second, kv.first));
+            }
+            snap.retired = snapshot_of(retired_stats_, 0);
+            snap.retired.alive = false;
+            snap.retired_workers = retired_workers_;
+        }
+        snap.queue_size = tasks_.size();
+        snap.live_threads = live_.load();
+        return snap;
+    }
+
+    // 析构：通知线程退出 + join 等待收尾
+    ~ThreadPool() {
+        std::unordered_map<std::thread::id, std::thread> workers;
+        std::vector<std::thread> retired;
+        {
+            std::lock_guard<std::mutex> lock(workers_mtx_);
+            stop_.store(true); // 持锁设置：之后不会再有新工人被创建或退休
+            workers.swap(workers_);
+            retired.swap(retired_);
+        }
+        tasks_.close(); // 关键：唤醒所有阻塞在 consume() 的工人
+
+        for (auto& kv : workers) {
+            if (kv.second.joinable()) kv.second.join();
+        }
+        for (auto& t : retired) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+private:
+    bool compensates_blocking() const {
+        return options_.max_threads > options_.min_threads && is_worker_thread();
+    }
+
+    struct TaskItem {
+        Task fn;
+        Clock::time_point enqueued;
+        bool must_run = false; // enqueue_must_run 提交的：DropOldest 不能丢它
+    };
+
+    bool handle_overflow(TaskItem item) {
+        switch (options_.overflow_policy) {
+            case OverflowPolicy::Reject:
+                rejected_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case OverflowPolicy::CallerRuns:
+                caller_runs_.fetch_add(1, std::memory_order_relaxed);
+                if (item.fn) item.fn();
+                return true;
+
+            case OverflowPolicy::DropOldest: {
+                // 只挤掉普通任务；队列里全是必须执行的延续时，新任务被拒绝
+                bool dropped = false;
+                QueueStatus status = tasks_.produce_drop_oldest(item, dropped,
+                                                                [](const TaskItem& t) { return t.must_run; });
+                if (status == QueueStatus::Full) rejected_.fetch_add(1, std::memory_order_relaxed);
+                if (status != QueueStatus::Ok) return false;
+                if (dropped) dropped_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            case OverflowPolicy::Spill: {
+                std::lock_guard<std::mutex> lock(spill_mtx_);
+                return push_spill_locked(std::move(item));
+            }
+
+            case OverflowPolicy::Block:
+            default:
+                return tasks_.produce(std::move(item));
+        }
+    }
+
+    // Spill 策略下溢出队列里还有更早的任务：新任务不能直接进主队列插到它们前面，排到溢出队列末尾
+    // spill_pending_ 只是快速路径上的提示，真正的判断在锁里再做一次。
+    // 返回 true 表示已经处理（accepted 是提交结果），false 表示照常走主队列
+    bool spill_behind(TaskItem& item, bool& accepted) {
+        if (options_.overflow_policy != OverflowPolicy::Spill) return false;
+        if (!spill_pending_.load(std::memory_order_acquire)) return false;
+        std::lock_guard<std::mutex> lock(spill_mtx_);
+        if (spill_.empty()) return false;
+        accepted = push_spill_locked(std::move(item));
+        return true;
+    }
+
+    // 放进溢出队列之后自己再回填一次：防止工人恰好在这之前把主队列取空了。调用者必须持有 spill_mtx_
+    // 析构已经开始时返回 false：退出前的工人可能已经把溢出队列收完了，再放进去就没人执行
+    bool push_spill_locked(TaskItem item) {
+        if (stop_.load()) return false;
+        spill_.push_back(std::move(item));
+        spilled_.fetch_add(1, std::memory_order_relaxed);
+        spill_pending_.store(true, std::memory_order_release);
+        drain_spill_locked();
+        return true;
+    }
+
+    // 把溢出队列里的任务按顺序搬回主队列，主队列满了就停。调用者必须持有 spill_mtx_
+    // 返回搬了几个
+    size_t drain_spill_locked() {
+        size_t moved = 0;
+        while (!spill_.empty()) {
+            if (tasks_.try_produce(spill_.front()) != QueueStatus::Ok) break;
+            spill_.pop_front();
+            ++moved;
+        }
+        if (spill_.empty()) spill_pending_.store(false, std::memory_order_release);
+        return moved;
+    }
+
+    size_t drain_spill() {
+        if (!spill_pending_.load(std::memory_order_acquire)) return 0;
+        std::lock_guard<std::mutex> lock(spill_mtx_);
+        return drain_spill_locked();
+    }
+
+    // 队列关闭后，溢出队列里剩下的任务由退出前的工人直接执行掉，不丢任务
+    bool pop_spill(TaskItem& item) {
+        std::lock_guard<std::mutex> lock(spill_mtx_);
+        if (spill_.empty()) return false;
+        item = std::move(spill_.front());
+        spill_.pop_front();
+        if (spill_.empty()) spill_pending_.store(false, std::memory_order_release);
+        return true;
+    }
+
+    // 调用者必须持有 workers_mtx_
+    void spawn_worker_locked() {
+        reap_retired_locked();
+        live_.fetch_add(1);
+        size_t index = next_worker_index_++;
+        WorkerStats* stats = nullptr;
+        if (options_.enable_metrics) {
+            auto& slot = worker_stats_[index];
+            slot = std::make_unique<WorkerStats>();
+            stats = slot.get();
+        }
+        std::thread t([this, index, stats]() { worker_loop(index, stats); });
+        auto id = t.get_id();
+        workers_.emplace(id, std::move(t));
+    }
+
+    // 退休的工人不能 join 自己，交给下一个持锁的人来 join
+    void reap_retired_locked() {
+        for (auto& t : retired_) {
+            if (t.joinable()) t.join();
+        }
+        retired_.clear();
+    }
+
+    // 空闲超时：线程数多于下限（阻塞中的工人不算）才允许退休。
+    // 退休的工人的统计并进 retired_stats_ 后删掉，返回 true 之后工人不能再碰自己的 WorkerStats
+    bool try_retire(size_t index) {
+        std::lock_guard<std::mutex> lock(workers_mtx_);
+        if (stop_.load()) return false;
+        if (live_.load() <= options_.min_threads + blocked_.load()) return false;
+
+        auto it = workers_.find(std::this_thread::get_id());
+        if (it == workers_.end()) return false;
+
+        retired_.push_back(std::move(it->second));
+        workers_.erase(it);
+        live_.fetch_sub(1);
+
+        auto stats = worker_stats_.find(index);
+        if (stats != worker_stats_.end()) {
+            retired_stats_.absorb(*stats->second);
+            ++retired_workers_;
+            worker_stats_.erase(stats);
+        }
+        return true;
+    }
+
+    void maybe_grow(size_t depth, Clock::duration waited) {
+        if (options_.max_threads <= options_.min_threads) return; // 固定模式
+        if (idle_.load() > 0) return; // 有人闲着，新任务马上就会被拿走
+
+        bool depth_hit = options_.scale_up_queue_depth > 0 &&
+                         depth >= options_.scale_up_queue_depth;
+        bool wait_hit = options_.scale_up_wait.count() > 0 &&
+                        waited >= options_.scale_up_wait;
+        if (!depth_hit && !wait_hit) return;
+
+        std::lock_guard<std::mutex> lock(workers_mtx_);
+        if (stop_.load()) return;
+        if (live_.load() < options_.max_threads + blocked_.load()) {
+            spawn_worker_locked();
+        }
+    }
+
+    void pin_worker(size_t index) {
+        if (options_.cpu_set.empty()) return;
+        if (options_.pin_per_core) {
+            CpuTopology::pin_current_thread({options_.cpu_set[index % options_.cpu_set.size()]});
+        } else {
+            CpuTopology::pin_current_thread(options_.cpu_set);
+        }
+    }
+
+    void worker_loop(size_t index, WorkerStats* stats) {
+        current_pool_ = this;
+        pin_worker(index);
+        Clock::time_point last_end = Clock::now();
+
+        while (true) {
+            TaskItem item;
+
+            idle_.fetch_add(1);
+            QueueStatus status = tasks_.consume_for(item, options_.idle_timeout);
+            idle_.fetch_sub(1);
+
+            // 队列关闭且已空 -> 把溢出队列收尾后安全退出线程
+            if (status == QueueStatus::Closed) {
+                while (pop_spill(item)) {
+                    if (item.fn) item.fn();
+                }
+                if (stats) stats->alive.store(false, std::memory_order_relaxed);
+                break;
+            }
+
+            if (status == QueueStatus::Timeout) {
+                // 空闲时间平时在下一个任务开始时结算；一直没活干的话，每次超时也结算一次
+                if (stats) {
+                    Clock::time_point now = Clock::now();
+                    single_writer_add(stats->idle_ns, to_ns(now - last_end));
+                    last_end = now;
+                }
+                if (try_retire(index)) return;
+                continue;
+            }
+
+            Clock::time_point start = Clock::now();
+
+            // 主队列空出一个位置，从溢出队列回填
+            size_t moved = drain_spill();
+            if (stats && moved) single_writer_add(stats->handoffs, moved);
+
+            // 排队等太久说明工人不够，顺手扩容
+            maybe_grow(tasks_.size(), start - item.enqueued);
+
+            // 正常执行任务
+            if (item.fn) item.fn();
+
+            if (stats) {
+                Clock::time_point end = Clock::now();
+                stats->record(to_ns(start - item.enqueued), to_ns(end - start), to_ns(start - last_end));
+                last_end = end;
+            }
+        }
+    }
+
+    static uint64_t to_ns(Clock::duration d) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        return ns < 0 ? 0 : static_cast<uint64_t>(ns);
+    }
+
+    static inline thread_local const ThreadPool* current_pool_ = nullptr;
+
+    ThreadPoolOptions options_;
+    SafeQueue<TaskItem> tasks_;
+
+    std::mutex workers_mtx_; // 保护 workers_ / retired_
+    std::unordered_map<std::thread::id, std::thread> workers_;
+    std::vector<std::thread> retired_;
+    size_t next_worker_index_ = 0; // 决定绑到哪个核，受 workers_mtx_ 保护
+    std::map<size_t, std::unique_ptr<WorkerStats>> worker_stats_; // 键是工人编号，只有在职的工人，受 workers_mtx_ 保护
+    WorkerStats retired_stats_;    // 已退休工人的汇总，受 workers_mtx_ 保护
+    size_t retired_workers_ = 0;
+
+    std::atomic<size_t> live_{0};    // 当前存活的工人数
+    std::atomic<size_t> idle_{0};    // 正在等任务的工人数
+    std::atomic<size_t> blocked_{0}; // 声明自己在阻塞的任务数
+    std::atomic<bool> stop_{false};
+
+    mutable std::mutex spill_mtx_; // 保护 spill_
+    std::deque<TaskItem> spill_;   // Spill 策略的无界溢出队列
+    std::atomic<bool> spill_pending_{false}; // spill_ 非空（锁里更新，锁外只当提示读）
+
+    // 溢出计数（只做统计，relaxed 就够了）
+    std::atomic<size_t> rejected_{0};
+    std::atomic<size_t> timed_out_{0};
+    std::atomic<size_t> caller_runs_{0};
+    std::atomic<size_t> dropped_{0};
+    std::atomic<size_t> spilled_{0};
+};
+
+// =========================
+// 定期把线程池埋点打印出来（文本或 JSON 一行一个快照）
+// =========================
+class MetricsDumper {
+public:
+    enum class Format { Text, Json };
+
+    MetricsDumper(ThreadPool& pool, std::chrono::milliseconds interval,
+                  std::ostream& out, Format format = Format::Text)
+            : pool_(pool), interval_(interval), out_(out), format_(format)
+    {
+        thread_ = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(mtx_);
+            while (!cv_.wait_for(lock, interval_, [this]() { return stop_; })) {
+                lock.unlock();
+                dump();
+                lock.lock();
+            }
+        });
+    }
+
+    MetricsDumper(const MetricsDumper&) = delete;
+    MetricsDumper& operator=(const MetricsDumper&) = delete;
+
+    ~MetricsDumper() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    void dump() {
+        PoolMetricsSnapshot snap = pool_.metrics();
+        if (format_ == Format::Json) {
+            out_ << snap.to_json() << std::endl;
+        } else {
+            out_ << snap.to_text() << std::flush;
+        }
+    }
+
+private:
+    ThreadPool& pool_;
+    std::chrono::milliseconds interval_;
+    std::ostream& out_;
+    Format format_;
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+    std::thread thread_;
+};
+
+#endif //CONCURRENCY_STUDY_THREADPOOL_H
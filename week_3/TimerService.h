@@ -0,0 +1,335 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_TIMERSERVICE_H
+#define CONCURRENCY_STUDY_TIMERSERVICE_H
+
+#include <vector>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+// =========================
+// 定时器服务：一个定时线程 + 分层时间轮，到期任务丢进 ThreadPool 执行
+// 代替“每个周期任务一个 sleep_for 线程”的写法
+//
+// 时间轮：4 层，每层 256 个槽，第 L 层一个槽代表 256^L 个 tick（共 2^32 个 tick）
+// 插入：按剩余 tick 数选层，按到期 tick 的对应 8 位选槽，O(1)
+// 取消：定时器节点是槽里双向链表的一员，直接摘掉，O(1)
+// 推进：第 0 层转满一圈时，把上一层当前槽的定时器重新分配（级联）到下层
+// 派发：用 enqueue_must_run 提交，不受 overflow_policy 影响：池满时进线程池的溢出队列，
+//       定时线程不会被卡住，回调也不会被 Reject 拒掉、被别的生产者的 DropOldest 挤掉
+// =========================
+class TimerService {
+public:
+    using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+    using TimerId = uint64_t; // 高 32 位：代数；低 32 位：节点下标。0 表示无效
+
+    explicit TimerService(ThreadPool& pool,
+                          std::chrono::milliseconds tick = std::chrono::milliseconds(1))
+            : pool_(pool), tick_(tick), start_(Clock::now())
+    {
+        heads_.fill(kNil);
+        thread_ = std::thread([this]() { run(); });
+    }
+
+    TimerService(const TimerService&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+
+    // 池满时排在溢出队列里的回调看线程池的 spill_size() / overflow_stats()
+    struct DispatchStats {
+        uint64_t dispatched = 0; // 已交给线程池的回调
+        uint64_t dropped = 0;    // 到期时线程池已经停止、没有执行的回调
+    };
+
+    // 停止定时线程；还没到期的定时器直接丢弃
+    ~TimerService() {
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        if (thread_.joinable()) thread_.join();
+    }
+
+    template<typename Rep, typename Period>
+    TimerId schedule_after(const std::chrono::duration<Rep, Period>& delay, Task task) {
+        return schedule_at(Clock::now() + delay, std::move(task));
+    }
+
+    TimerId schedule_at(Clock::time_point when, Task task) {
+        return add(when, 0, std::move(task));
+    }
+
+    // 周期任务：第一次在 initial_delay 之后（默认等于 period），之后每 period 一次
+    template<typename Rep, typename Period>
+    TimerId schedule_every(const std::chrono::duration<Rep, Period>& period, Task task) {
+        return schedule_every(period, std::move(task), period);
+    }
+
+    template<typename Rep1, typename Period1, typename Rep2, typename Period2>
+    TimerId schedule_every(const std::chrono::duration<Rep1, Period1>& period, Task task,
+                           const std::chrono::duration<Rep2, Period2>& initial_delay) {
+        uint64_t period_ticks = to_ticks_ceil(period);
+        if (period_ticks == 0) period_ticks = 1;
+        return add(Clock::now() + initial_delay, period_ticks, std::move(task));
+    }
+
+    // 取消：成功返回 true；已经触发过的一次性定时器 / 已取消的返回 false
+    // 周期任务取消后，正在执行的那一次不受影响，之后不再触发
+    bool cancel(TimerId id) {
+        uint32_t index = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+        uint32_t generation = static_cast<uint32_t>(id >> 32);
+
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (index >= nodes_.size()) return false;
+        Node& node = nodes_[index];
+        if (node.generation != generation || node.bucket == kNoBucket) return false;
+
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return count_;
+    }
+
+    DispatchStats dispatch_stats() const {
+        DispatchStats s;
+        s.dispatched = dispatched_.load(std::memory_order_relaxed);
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    static constexpr uint32_t kNil = 0xFFFFFFFFu;
+    static constexpr uint16_t kNoBucket = 0xFFFF;
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 8;
+    static constexpr uint64_t kSlots = 1u << kSlotBits;
+    static constexpr uint64_t kSlotMask = kSlots - 1;
+    static constexpr uint64_t kMaxDelta = (uint64_t{1} << (kSlotBits * kLevels)) - 1;
+
+    struct Node {
+        uint64_t expire = 0;       // 到期 tick
+        uint64_t period = 0;       // 周期（tick），0 表示一次性
+        uint32_t prev = kNil;
+        uint32_t next = kNil;      // 槽内链表；空闲时复用为空闲链表
+        uint32_t generation = 1;   // 节点复用时 +1，旧 TimerId 自动失效
+        uint16_t bucket = kNoBucket; // level * 256 + slot
+        Task task;
+    };
+
+    template<typename Rep, typename Period>
+    uint64_t to_ticks_ceil(const std::chrono::duration<Rep, Period>& d) const {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        auto tick_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tick_).count();
+        if (ns <= 0) return 0;
+        return static_cast<uint64_t>((ns + tick_ns - 1) / tick_ns);
+    }
+
+    // 时间点 -> tick 编号（向上取整：宁可晚一点，不能早触发）
+    uint64_t tick_of(Clock::time_point t) const {
+        return to_ticks_ceil(t - start_);
+    }
+
+    TimerId add(Clock::time_point when, uint64_t period, Task task) {
+        uint64_t expire = tick_of(when);
+        bool wake = false;
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            if (count_ == 0) {
+                // 轮子空着的时候定时线程不转，先把 current_ 追到现在，新定时器才能按真实剩余时间入轮
+                uint64_t now_tick = static_cast<uint64_t>((Clock::now() - start_) / tick_);
+                current_ = std::max(current_, now_tick);
+            }
+            uint32_t index = allocate();
+            Node& node = nodes_[index];
+            node.expire = expire;
+            node.period = period;
+            node.task = std::move(task);
+            place(index, current_ + 1);
+            wake = (++count_ == 1); // 从空变非空：定时线程可能在无限期睡眠，叫醒它
+            id = (static_cast<uint64_t>(node.generation) << 32) | index;
+        }
+        if (wake) cv_.notify_one();
+        return id;
+    }
+
+    uint32_t allocate() {
+        if (free_head_ != kNil) {
+            uint32_t index = free_head_;
+            free_head_ = nodes_[index].next;
+            nodes_[index].next = kNil;
+            return index;
+        }
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    void release(uint32_t index) {
+        Node& node = nodes_[index];
+        node.task = nullptr;
+        ++node.generation;
+        if (node.generation == 0) node.generation = 1;
+        node.next = free_head_;
+        free_head_ = index;
+        --count_;
+    }
+
+    // 按到期时间放进合适的层和槽
+    // earliest：最早能触发的 tick。新插入的是 current_ + 1（current_ 这一格已经处理过了）；
+    // 级联时是 current_ 本身（这一格的第 0 层槽马上就要处理）
+    void place(uint32_t index, uint64_t earliest) {
+        Node& node = nodes_[index];
+        if (node.expire < earliest) node.expire = earliest; // 已经过期的：尽快触发
+
+        uint64_t delta = node.expire - current_;
+        uint64_t target = node.expire;
+        if (delta > kMaxDelta) target = current_ + kMaxDelta; // 超出时间轮范围：先放最远处，级联时再算
+
+        int level = 0;
+        while (level < kLevels - 1 && (target - current_) >= (uint64_t{1} << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+        uint64_t slot = (target >> (kSlotBits * level)) & kSlotMask;
+        uint16_t bucket = static_cast<uint16_t>(level * kSlots + slot);
+
+        node.bucket = bucket;
+        node.prev = kNil;
+        node.next = heads_[bucket];
+        if (node.next != kNil) nodes_[node.next].prev = index;
+        heads_[bucket] = index;
+    }
+
+    void unlink(uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != kNil) nodes_[node.prev].next = node.next;
+        else heads_[node.bucket] = node.next;
+        if (node.next != kNil) nodes_[node.next].prev = node.prev;
+        node.prev = node.next = kNil;
+        node.bucket = kNoBucket;
+    }
+
+    // 把某层某槽的定时器整体摘下来，按新的剩余时间重新放置
+    void cascade(int level, uint64_t slot) {
+        uint16_t bucket = static_cast<uint16_t>(level * kSlots + slot);
+        uint32_t index = heads_[bucket];
+        heads_[bucket] = kNil;
+        while (index != kNil) {
+            uint32_t next = nodes_[index].next;
+            nodes_[index].bucket = kNoBucket;
+            place(index, current_);
+            index = next;
+        }
+    }
+
+    // 推进一个 tick，把到期的任务收集到 due 里（持锁调用）
+    void advance_one(std::vector<Task>& due) {
+        ++current_;
+        if ((current_ & kSlotMask) == 0) {
+            // 第 0 层转满一圈；如果第 1 层也刚好转满，先从更高层级联下来
+            int top = 1;
+            while (top + 1 < kLevels && ((current_ >> (kSlotBits * top)) & kSlotMask) == 0) ++top;
+            for (int level = top; level >= 1; --level) {
+                cascade(level, (current_ >> (kSlotBits * level)) & kSlotMask);
+            }
+        }
+
+        uint16_t bucket = static_cast<uint16_t>(current_ & kSlotMask);
+        uint32_t index = heads_[bucket];
+        heads_[bucket] = kNil;
+        while (index != kNil) {
+            Node& node = nodes_[index];
+            uint32_t next = node.next;
+            node.prev = node.next = kNil;
+            node.bucket = kNoBucket;
+
+            if (node.period > 0) {
+                due.push_back(node.task); // 周期任务：拷贝一份去执行，节点重新入轮
+                node.expire = current_ + node.period;
+                place(index, current_ + 1);
+            } else {
+                due.push_back(std::move(node.task));
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    // 不持锁调用，按触发顺序交给线程池
+    // enqueue_must_run 从不阻塞、池满也不拒绝，只有线程池已经停止时失败
+    void dispatch(std::vector<Task>& due) {
+        uint64_t sent = 0;
+        for (auto& task : due) {
+            if (pool_.enqueue_must_run(std::move(task))) ++sent;
+        }
+        dispatched_.fetch_add(sent, std::memory_order_relaxed);
+        dropped_.fetch_add(due.size() - sent, std::memory_order_relaxed);
+        due.clear();
+    }
+
+    void run() {
+        std::vector<Task> due;
+        std::unique_lock<std::mutex> lock(mtx_);
+        while (!stop_) {
+            if (count_ == 0) {
+                cv_.wait(lock, [this]() { return stop_ || count_ > 0; });
+                if (stop_) break;
+            } else {
+                cv_.wait_until(lock, start_ + tick_ * static_cast<Clock::rep>(current_ + 1),
+                               [this]() { return stop_; });
+                if (stop_) break;
+            }
+
+            // 当前时间对应的 tick（向下取整），把落后的 tick 都补上
+            auto elapsed = Clock::now() - start_;
+            uint64_t now_tick = static_cast<uint64_t>(elapsed / tick_);
+            if (count_ == 0) {
+                current_ = std::max(current_, now_tick); // 空轮直接跳过去，不用一格一格转
+            } else {
+                while (current_ < now_tick) advance_one(due);
+            }
+
+            if (!due.empty()) {
+                lock.unlock();
+                dispatch(due);
+                lock.lock();
+            }
+        }
+    }
+
+    ThreadPool& pool_;
+    Clock::duration tick_;
+    Clock::time_point start_;
+
+    mutable std::mutex mtx_; // 保护下面所有状态
+    std::condition_variable cv_;
+    bool stop_ = false;
+
+    uint64_t current_ = 0;                          // 已经处理到的 tick
+    std::array<uint32_t, kLevels * kSlots> heads_{}; // 每个槽的链表头
+    std::vector<Node> nodes_;                       // 定时器节点池（按下标引用，扩容不影响）
+    uint32_t free_head_ = kNil;
+    size_t count_ = 0;                              // 未触发的定时器数
+
+    std::atomic<uint64_t> dispatched_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::thread thread_;
+};
+
+#endif //CONCURRENCY_STUDY_TIMERSERVICE_H
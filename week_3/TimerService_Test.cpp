@@ -0,0 +1,113 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include "TimerService.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    ThreadPoolOptions opt = ThreadPoolOptions::fixed(2);
+    opt.overflow_policy = OverflowPolicy::Spill; // 定时线程不能被满队列卡住
+    ThreadPool pool(opt);
+    TimerService timers(pool);
+
+    // 1. 周期任务：一个定时线程代替“每个任务一个 sleep_for 线程”
+    std::atomic<int> ticks{0};
+    auto periodic = timers.schedule_every(std::chrono::milliseconds(100), [&ticks] { ++ticks; });
+
+    // 2. 一百万个定时器：插入 + 取消一半
+    const int N = 1000000;
+    std::vector<TimerService::TimerId> ids(N);
+    std::atomic<int> fired{0};
+    std::atomic<long long> max_late_us{0};
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<> delay_ms(1500, 2500);
+
+    auto t0 = Clock::now();
+    for (int i = 0; i < N; ++i) {
+        auto due = Clock::now() + std::chrono::milliseconds(delay_ms(gen));
+        ids[i] = timers.schedule_at(due, [due, &fired, &max_late_us] {
+            long long late = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - due).count();
+            long long cur = max_late_us.load();
+            while (late > cur && !max_late_us.compare_exchange_weak(cur, late)) {}
+            ++fired;
+        });
+    }
+    auto t1 = Clock::now();
+    int cancelled = 0;
+    for (int i = 0; i < N; i += 2) {
+        if (timers.cancel(ids[i])) ++cancelled;
+    }
+    auto t2 = Clock::now();
+
+    auto per_op = [](Clock::duration d, int n) {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count()) / n;
+    };
+    std::cout << "插入 " << N << " 个定时器: 平均 " << per_op(t1 - t0, N) << " ns/个" << std::endl;
+    std::cout << "取消 " << cancelled << " 个定时器: 平均 " << per_op(t2 - t1, cancelled) << " ns/个" << std::endl;
+    std::cout << "待触发: " << timers.pending() << std::endl;
+
+    // 3. schedule_after / 取消已触发的定时器
+    std::atomic<bool> once{false};
+    auto one_shot = timers.schedule_after(std::chrono::milliseconds(50), [&once] { once = true; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(2700));
+    timers.cancel(periodic);
+
+    std::cout << "触发: " << fired.load() << " (应为 " << N - cancelled << ")"
+              << "，最大延迟: " << max_late_us.load() / 1000.0 << " ms" << std::endl;
+    std::cout << "周期任务触发次数: " << ticks.load() << std::endl;
+    std::cout << "一次性任务: " << (once ? "已触发" : "未触发")
+              << "，再取消: " << (timers.cancel(one_shot) ? "成功" : "失败(已触发)") << std::endl;
+
+    // 4. 小队列 + DropOldest 的池：同一时刻到期 200 个慢回调，同时还有别人往池里灌普通任务；
+    //    回调池满时进溢出队列，被挤掉的只能是普通任务，回调一个都不丢
+    {
+        ThreadPoolOptions small = ThreadPoolOptions::fixed(1);
+        small.queue_capacity = 4;
+        small.overflow_policy = OverflowPolicy::DropOldest;
+        ThreadPool slow_pool(small);
+        TimerService slow_timers(slow_pool);
+
+        const int M = 200;
+        std::atomic<int> done{0};
+        auto due = Clock::now() + std::chrono::milliseconds(20);
+        for (int i = 0; i < M; ++i) {
+            slow_timers.schedule_at(due, [&done] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++done;
+            });
+        }
+        // 池满期间定时线程照常转：这个定时器不该被前面的 200 个拖住
+        std::atomic<bool> light{false};
+        slow_timers.schedule_after(std::chrono::milliseconds(40), [&light] { light = true; });
+
+        std::this_thread::sleep_until(due + std::chrono::milliseconds(5));
+        for (int i = 0; i < 1000; ++i) slow_pool.enqueue([] {});
+
+        while (done.load() < M) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto s = slow_timers.dispatch_stats();
+        std::cout << "DropOldest 池: 执行 " << done.load() << " / " << M << "，派发 " << s.dispatched
+                  << "，丢弃 " << s.dropped << "，被挤掉 / 拒绝的普通任务 " << slow_pool.overflow_stats().dropped
+                  << " / " << slow_pool.overflow_stats().rejected
+                  << "，排在后面的定时器: " << (light ? "已触发" : "未触发") << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,355 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#ifndef CONCURRENCY_STUDY_WORKSTEALINGPOOL_H
+#define CONCURRENCY_STUDY_WORKSTEALINGPOOL_H
+
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+#include <type_traits>
+#include <cstdint>
+
+// =========================
+// 工作窃取线程池 (fork-join)
+// 和 ThreadPool 的区别：ThreadPool 是一个共享的有界队列 + std::function，适合互不相干的任务；
+// 这里每个工人有自己的双端队列，join(a, b) 把 a 压到自己队尾、自己接着跑 b，
+// 空闲的工人从别人的队头偷。任务对象就放在 join 的栈帧里，fork 一次不分配内存。
+// 等 a 的时候不阻塞：a 还在自己队里就直接取回来跑；被偷走了就边等边去偷别的任务跑，
+// 所以递归多深都不会把工人全卡在“等子任务”上
+// =========================
+
+namespace ws_detail {
+
+// 一个可以被偷走执行的任务；done 由执行者 release 写、等待者 acquire 读
+struct Job {
+    std::atomic<bool> done{false};
+    virtual void execute() noexcept = 0;
+
+protected:
+    ~Job() = default;
+};
+
+// 放在栈上的任务：只持有可调用对象的指针，异常留给等待者重新抛出
+template<typename F>
+struct StackJob final : Job {
+    F* fn;
+    std::exception_ptr error;
+
+    explicit StackJob(F& f) : fn(&f) {}
+
+    void execute() noexcept override {
+        try {
+            (*fn)();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        // 这一句之后等待者可能立刻返回、销毁本对象，不能再碰任何成员
+        done.store(true, std::memory_order_release);
+    }
+};
+
+// 外部线程提交的根任务：执行完通过条件变量叫醒提交者
+template<typename F>
+struct RootJob final : Job {
+    F* fn;
+    std::exception_ptr error;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool finished = false;
+
+    explicit RootJob(F& f) : fn(&f) {}
+
+    void execute() noexcept override {
+        try {
+            (*fn)();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        finished = true;
+        cv.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [this]() { return finished; });
+    }
+};
+
+// Chase-Lev 双端队列（固定容量）：
+// 主人在 bottom 端 push/pop，不和别人竞争，只在只剩最后一个元素时和小偷 CAS 一次 top；
+// 小偷在 top 端 steal，彼此之间 CAS top。fork-join 的队列深度 ≈ 递归深度，几千个槽足够，
+// 满了 push 返回 false，调用者就地串行执行
+class WorkDeque {
+public:
+    static constexpr int64_t kCapacity = 1 << 12;
+
+    WorkDeque() : slots_(new std::atomic<Job*>[kCapacity]) {
+        for (int64_t i = 0; i < kCapacity; ++i) slots_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // 只有主人调用
+    bool push(Job* job) {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+        if (b - t >= kCapacity) return false;
+        slots_[b & kMask].store(job, std::memory_order_relaxed);
+        bottom_.store(b + 1, std::memory_order_release); // 和 steal 里读 bottom 配对：任务内容先可见
+        return true;
+    }
+
+    // 只有主人调用：取最后压进去的（LIFO，缓存最热）
+    Job* pop() {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // 先让小偷看到 bottom 变小，再读 top
+        int64_t t = top_.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed); // 空的
+            return nullptr;
+        }
+        Job* job = slots_[b & kMask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // 最后一个：和小偷抢
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                job = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // 任何线程都可以调用：取最早压进去的（FIFO，通常是最大的一块活）
+    Job* steal() {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        Job* job = slots_[t & kMask].load(std::memory_order_relaxed);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr; // 被别的小偷或主人抢先了
+        }
+        return job;
+    }
+
+private:
+    static constexpr int64_t kMask = kCapacity - 1;
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::unique_ptr<std::atomic<Job*>[]> slots_;
+};
+
+} // namespace ws_detail
+
+class WorkStealingPool {
+public:
+    // threads = 0 表示每个逻辑 CPU 一个工人
+    explicit WorkStealingPool(size_t threads = 0) {
+        if (threads == 0) threads = std::thread::hardware_concurrency();
+        if (threads == 0) threads = 2;
+        for (size_t i = 0; i < threads; ++i) workers_.push_back(std::make_unique<Worker>());
+        for (size_t i = 0; i < threads; ++i) {
+            workers_[i]->rng = 0x9E3779B97F4A7C15ull * (i + 1);
+            workers_[i]->thread = std::thread([this, i]() { worker_loop(i); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // 析构时不能还有 run() 在进行（run 是阻塞的，正常用法下不会发生）
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mtx_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (auto& w : workers_) {
+            if (w->thread.joinable()) w->thread.join();
+        }
+    }
+
+    size_t thread_count() const { return workers_.size(); }
+
+    bool is_worker_thread() const { return current_pool_ == this; }
+
+    // 在池里执行 f，并等它（以及它 fork 出的所有子任务）结束；f 抛的异常在这里重新抛出
+    // 工人线程里调用就是直接调用 f；外部线程调用会阻塞在条件变量上，不占工人
+    template<typename F>
+    void run(F&& f) {
+        if (is_worker_thread()) {
+            f();
+            return;
+        }
+        ws_detail::RootJob<std::remove_reference_t<F>> job(f);
+        {
+            std::lock_guard<std::mutex> lock(inject_mtx_);
+            injected_.push_back(&job);
+            injected_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+        wake_one();
+        job.wait();
+        if (job.error) std::rethrow_exception(job.error);
+    }
+
+    // fork-join：a 和 b 可能并行执行，两者都结束后才返回
+    // a 压进本工人的队列等人来偷，b 在当前线程执行；随后取回 a 自己跑，或者边帮忙边等小偷跑完
+    // 两边都抛异常时只重新抛出 a 的
+    template<typename A, typename B>
+    void join(A&& a, B&& b) {
+        if (!is_worker_thread()) {
+            run([&]() { join(a, b); });
+            return;
+        }
+        Worker& me = *workers_[current_index_];
+
+        ws_detail::StackJob<std::remove_reference_t<A>> job_a(a);
+        if (!me.deque.push(&job_a)) {
+            a();
+            b();
+            return;
+        }
+        wake_one();
+
+        std::exception_ptr error_b;
+        try {
+            b();
+        } catch (...) {
+            error_b = std::current_exception();
+        }
+
+        wait_helping(me, job_a);
+        if (job_a.error) std::rethrow_exception(job_a.error);
+        if (error_b) std::rethrow_exception(error_b);
+    }
+
+private:
+    struct Worker {
+        ws_detail::WorkDeque deque;
+        std::thread thread;
+        uint64_t rng = 0; // 选偷窃对象用的 xorshift 状态，只有本工人访问
+    };
+
+    // 等 job 结束。先看它是不是还在自己队尾（没人偷，直接跑，最常见）；
+    // 被偷走了就去跑别的任务，而不是睡觉 —— 小偷 fork 出来的子任务往往正好能被我们偷回来
+    void wait_helping(Worker& me, ws_detail::Job& job) {
+        while (!job.done.load(std::memory_order_acquire)) {
+            ws_detail::Job* other = me.deque.pop();
+            if (other == nullptr) other = steal_any(me);
+            if (other != nullptr) {
+                other->execute();
+                continue;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    ws_detail::Job* pop_injected() {
+        if (injected_count_.load(std::memory_order_relaxed) == 0) return nullptr;
+        std::lock_guard<std::mutex> lock(inject_mtx_);
+        if (injected_.empty()) return nullptr;
+        ws_detail::Job* job = injected_.front();
+        injected_.pop_front();
+        injected_count_.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+    }
+
+    // 从随机位置开始把所有其他工人偷一遍
+    ws_detail::Job* steal_any(Worker& me) {
+        size_t n = workers_.size();
+        me.rng ^= me.rng << 13;
+        me.rng ^= me.rng >> 7;
+        me.rng ^= me.rng << 17;
+        size_t start = static_cast<size_t>(me.rng % n);
+        for (size_t k = 0; k < n; ++k) {
+            Worker& victim = *workers_[(start + k) % n];
+            if (&victim == &me) continue;
+            if (ws_detail::Job* job = victim.deque.steal()) return job;
+        }
+        return nullptr;
+    }
+
+    ws_detail::Job* find_work(Worker& me) {
+        if (ws_detail::Job* job = me.deque.pop()) return job;
+        if (ws_detail::Job* job = pop_injected()) return job;
+        return steal_any(me);
+    }
+
+    // 有人睡着才去拿锁；和 worker_loop 里“先登记 sleepers 再检查一遍”配对，不会漏唤醒
+    void wake_one() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) == 0) return;
+        {
+            std::lock_guard<std::mutex> lock(sleep_mtx_);
+            ++wake_epoch_;
+        }
+        sleep_cv_.notify_one();
+    }
+
+    void worker_loop(size_t index) {
+        current_pool_ = this;
+        current_index_ = index;
+        Worker& me = *workers_[index];
+
+        while (true) {
+            // 找活：先自旋一小会儿，fork-join 的任务往往马上就会冒出来
+            ws_detail::Job* job = nullptr;
+            for (int spin = 0; spin < 64 && job == nullptr; ++spin) {
+                job = find_work(me);
+                if (job == nullptr) std::this_thread::yield();
+            }
+            if (job != nullptr) {
+                job->execute();
+                continue;
+            }
+
+            // 准备睡：先登记，再最后检查一遍
+            uint64_t seen;
+            {
+                std::lock_guard<std::mutex> lock(sleep_mtx_);
+                if (stop_) return;
+                seen = wake_epoch_;
+            }
+            sleepers_.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            job = find_work(me);
+            if (job == nullptr) {
+                std::unique_lock<std::mutex> lock(sleep_mtx_);
+                sleep_cv_.wait(lock, [&]() { return stop_ || wake_epoch_ != seen; });
+            }
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            if (job != nullptr) job->execute();
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex inject_mtx_;                 // 外部线程提交的根任务
+    std::deque<ws_detail::Job*> injected_;
+    std::atomic<size_t> injected_count_{0};
+
+    std::mutex sleep_mtx_;
+    std::condition_variable sleep_cv_;
+    std::atomic<size_t> sleepers_{0};
+    uint64_t wake_epoch_ = 0;               // sleep_mtx_ 保护
+    bool stop_ = false;                     // sleep_mtx_ 保护
+
+    static inline thread_local const WorkStealingPool* current_pool_ = nullptr;
+    static inline thread_local size_t current_index_ = 0;
+};
+
+// 常驻的默认工作窃取池：第一次用到时创建，每个逻辑 CPU 一个工人
+inline WorkStealingPool& default_work_stealing_pool() {
+    static WorkStealingPool pool;
+    return pool;
+}
+
+#endif //CONCURRENCY_STUDY_WORKSTEALINGPOOL_H
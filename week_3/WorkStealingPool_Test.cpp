@@ -0,0 +1,114 @@
+//
+// Created by Administrator on 2026/10/18.
+//
+
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <algorithm>
+#include <stdexcept>
+#include "WorkStealingPool.h"
+#include "ParallelSort.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+// 最朴素的递归斐波那契：几百万次 fork，每次的活只有几纳秒，专门测 fork/join 本身的开销
+// NOLINTNEXTLINE(misc-no-recursion)
+long long fib(WorkStealingPool& pool, int n) {
+    if (n < 2) return n;
+    if (n < 16) return fib(pool, n - 1) + fib(pool, n - 2);
+    long long a = 0, b = 0;
+    pool.join([&]() { a = fib(pool, n - 1); }, [&]() { b = fib(pool, n - 2); });
+    return a + b;
+}
+
+// 旧版本：每次切分一个 std::async
+// NOLINTNEXTLINE(misc-no-recursion)
+template<typename RandomIt>
+void async_merge_sort(RandomIt begin, RandomIt end) {
+    auto len = std::distance(begin, end);
+    if (len < 1000) {
+        std::sort(begin, end);
+        return;
+    }
+    RandomIt mid = begin + len / 2;
+    if (len > 100000) {
+        auto left = std::async(std::launch::async | std::launch::deferred, [begin, mid]() { async_merge_sort(begin, mid); });
+        async_merge_sort(mid, end);
+        left.get();
+    } else {
+        async_merge_sort(begin, mid);
+        async_merge_sort(mid, end);
+    }
+    std::inplace_merge(begin, mid, end);
+}
+
+double ms_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main() {
+#ifdef _WIN32
+    SetConsoleOutputCP(CP_UTF8);
+    SetConsoleCP(CP_UTF8);
+#endif
+
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores == 0) cores = 2;
+
+    // 1. fork-join 开销
+    {
+        WorkStealingPool pool;
+        auto start = Clock::now();
+        long long r = fib(pool, 32);
+        std::cout << "fib(32) = " << r << "，" << pool.thread_count() << " 个工人，耗时 " << ms_since(start) << " ms" << std::endl;
+    }
+
+    // 2. 1000 万个 int：std::sort / 旧的 std::async 版本 / 不同工人数的工作窃取版本
+    const size_t N = 10000000;
+    std::vector<int> source(N);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(1, 1000000000);
+    for (auto& x : source) x = dis(gen);
+
+    std::vector<int> data = source;
+    auto start = Clock::now();
+    std::sort(data.begin(), data.end());
+    double base = ms_since(start);
+    std::cout << "std::sort (单线程)       : " << base << " ms" << std::endl;
+
+    data = source;
+    start = Clock::now();
+    async_merge_sort(data.begin(), data.end());
+    std::cout << "std::async 每次切分一个   : " << ms_since(start) << " ms" << std::endl;
+
+    std::vector<unsigned int> thread_counts;
+    for (unsigned int t = 1; t < cores; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(cores); // 最后一轮用满全部核心
+    for (unsigned int t : thread_counts) {
+        WorkStealingPool pool(t);
+        data = source;
+        start = Clock::now();
+        parallel_merge_sort(pool, data.begin(), data.end());
+        double ms = ms_since(start);
+        std::cout << "工作窃取 " << t << " 个工人" << (t < 10 ? " " : "") << "          : " << ms << " ms，加速比 "
+                  << base / ms << "x" << (std::is_sorted(data.begin(), data.end()) ? "" : " (没排好!)") << std::endl;
+    }
+
+    // 3. 异常：子任务抛出的异常在 join / run 里重新抛出
+    try {
+        WorkStealingPool pool(2);
+        pool.join([]() { throw std::runtime_error("左半边失败"); }, []() {});
+    } catch (const std::exception& e) {
+        std::cout << "捕获到子任务异常: " << e.what() << std::endl;
+    }
+
+    return 0;
+}